@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace FarMemoryContainer
+{
+
+//! The trace of the pages touched by queries, e.g., by `visit_query()` of the containers, is a binary file of 64-bit words:
+//!   * the page size in bytes first,
+//!   * `page_id << 1 | is_local` for each access, where `page_id` is the address divided by the page size,
+//!     and `is_local` is whether the address is in the purely local region, which is never swapped
+//!   * `AccessTraceQueryEnd` after the accesses of each query
+constexpr uint64_t AccessTraceQueryEnd = ~uint64_t{0};
+
+//! records the accesses given as `trace(address, is_local)` into a file in the format above
+class AccessTraceWriter
+{
+public:
+    //! @throw std::runtime_error if the file cannot be opened
+    AccessTraceWriter(const std::string& path, size_t page_size)
+        : file(path, std::ios::binary | std::ios::trunc), page_size(page_size)
+    {
+        if (!file) {
+            throw std::runtime_error{"cannot open the trace file: " + path};
+        }
+        buffer.reserve(BufferSize);
+        buffer.push_back(page_size);
+    }
+    ~AccessTraceWriter() { flush(); }
+
+    void operator()(const void* address, bool is_local)
+    {
+        put(reinterpret_cast<uintptr_t>(address) / page_size << 1 | (is_local ? 1 : 0));
+    }
+    void end_query()
+    {
+        put(AccessTraceQueryEnd);
+        n_queries_++;
+    }
+    size_t n_queries() const noexcept { return n_queries_; }
+
+    void flush()
+    {
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(uint64_t)));
+        file.flush();
+        buffer.clear();
+    }
+
+private:
+    static constexpr size_t BufferSize = 1 << 16;
+
+    void put(uint64_t word)
+    {
+        buffer.push_back(word);
+        if (buffer.size() == BufferSize) {
+            flush();
+        }
+    }
+
+    std::ofstream file;
+    size_t page_size;
+    std::vector<uint64_t> buffer;
+    size_t n_queries_ = 0;
+};
+
+//! reads a trace written by `AccessTraceWriter`
+class AccessTraceReader
+{
+public:
+    //! @throw std::runtime_error if the file cannot be opened or is not a trace
+    explicit AccessTraceReader(const std::string& path)
+        : file(path, std::ios::binary)
+    {
+        if (!file || !file.read(reinterpret_cast<char*>(&page_size_), sizeof(page_size_)) || page_size_ == 0) {
+            throw std::runtime_error{"not a trace file: " + path};
+        }
+    }
+
+    size_t page_size() const noexcept { return page_size_; }
+
+    //! calls `access(page_id, is_local)` for each access and `end_query()` after each query, from the beginning of the trace
+    template <class Access, class EndQuery>
+    void replay(Access&& access, EndQuery&& end_query)
+    {
+        file.clear();
+        file.seekg(sizeof(uint64_t));
+        std::vector<uint64_t> buffer(1 << 16);
+        while (file) {
+            file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(uint64_t)));
+            const size_t n_words = static_cast<size_t>(file.gcount()) / sizeof(uint64_t);
+            for (size_t i = 0; i != n_words; i++) {
+                if (buffer[i] == AccessTraceQueryEnd) {
+                    end_query();
+                } else {
+                    access(static_cast<uintptr_t>(buffer[i] >> 1), (buffer[i] & 1) != 0);
+                }
+            }
+        }
+    }
+
+private:
+    std::ifstream file;
+    uint64_t page_size_ = 0;
+};
+
+}  // namespace FarMemoryContainer
@@ -0,0 +1,327 @@
+#pragma once
+
+#include <farmalloc/collective_allocator_traits.hpp>
+#include <far_memory_container/aligned_buffer.hpp>
+#include <far_memory_container/key_search.hpp>
+#include <far_memory_container/placement.hpp>
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+
+namespace FarMemoryContainer
+{
+
+using namespace FarMalloc;
+
+namespace Blocked
+{
+
+template <class PtrToVal, size_t MaxNKeys, size_t MaxNElems>
+struct BPlusTreeInner;
+
+//! a node holding the elements, i.e., the values
+template <class PtrToVal, size_t MaxNKeys, size_t MaxNElems>
+struct BPlusTreeLeaf {
+    using value_type = std::remove_reference_t<decltype(*std::declval<PtrToVal>())>;
+    using LeafPtr = typename std::pointer_traits<PtrToVal>::template rebind<BPlusTreeLeaf>;
+    using InnerPtr = typename std::pointer_traits<PtrToVal>::template rebind<BPlusTreeInner<PtrToVal, MaxNKeys, MaxNElems>>;
+
+    size_t n_elems;
+    InnerPtr parent;
+    // All the leaves compose a doubly-linked list in ascending order of the keys.
+    // The first and the last are the sentinel leaf, which has no element.
+    LeafPtr prev, next;
+    std::array<AlignedBuffer<value_type>, MaxNElems> elems{};
+
+    template <class Key, class key_compare>
+    inline size_t upper_bound(const Key& key, key_compare& comp) const;
+};
+
+//! a node holding only the keys and the pointers to the children, all of which are inner nodes or all of which are leaves
+template <class PtrToVal, size_t MaxNKeys, size_t MaxNElems>
+struct BPlusTreeInner {
+    using value_type = std::remove_reference_t<decltype(*std::declval<PtrToVal>())>;
+    using key_type = std::remove_const_t<typename value_type::first_type>;
+    using LeafPtr = typename BPlusTreeLeaf<PtrToVal, MaxNKeys, MaxNElems>::LeafPtr;
+    using InnerPtr = typename BPlusTreeLeaf<PtrToVal, MaxNKeys, MaxNElems>::InnerPtr;
+
+    // Only the member selected by `is_bottom` is used.
+    union Children {
+        std::array<InnerPtr, MaxNKeys + 1> inner{};
+        std::array<LeafPtr, MaxNKeys + 1> leaves;
+    };
+    static_assert(std::is_trivially_copyable_v<InnerPtr> && std::is_trivially_copyable_v<LeafPtr>);
+
+    size_t n_keys;
+    // whether the children are leaves
+    bool is_bottom;
+    // invariant: keys[i - 1] <= (the keys in children[i]) < keys[i]
+    std::array<key_type, MaxNKeys> keys;
+    Children children;
+    InnerPtr parent;
+
+    template <class Key, class key_compare>
+    size_t upper_bound(const Key& key, key_compare& comp) const { return upper_bound_in_keys(keys, n_keys, key, comp); }
+    //! calls `f` with `children.leaves` or `children.inner`, whichever is used
+    template <class F>
+    inline void visit_children(F&& f);
+    //! calls `f` with the children of this node and those of `sibling`, which is at the same depth
+    template <class F>
+    inline void visit_children(BPlusTreeInner& sibling, F&& f);
+};
+
+template <class Leaf>
+struct BPlusTreeIterBase {
+    using value_type = typename Leaf::value_type;
+    using LeafPtr = typename Leaf::LeafPtr;
+
+    LeafPtr leaf = nullptr;
+    size_t elem_idx = 0;
+
+    friend bool operator==(const BPlusTreeIterBase& lhs, const BPlusTreeIterBase& rhs) noexcept { return lhs.elem_idx == rhs.elem_idx && lhs.leaf == rhs.leaf; }
+
+    value_type* get() const noexcept { return leaf->elems[elem_idx].get(); }
+
+    inline void increment();
+    inline void decrement();
+};
+
+//! B+-tree, whose inner nodes hold only the keys so that the whole index fits in the purely local region.
+//! The elements are held only in the leaves, which are allocated in the swappable region through another rebound suballocator,
+//! and therefore a lookup swaps in at most a page as long as the inner nodes are purely local.
+//! The inner nodes are allocated in the purely local region while it has room, and in the swappable region after that.
+//! @tparam MaxNKeys the maximum number of the keys in an inner node
+//! @tparam MaxNElems the maximum number of the elements in a leaf
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare = std::less<Key>, class Allocator = std::allocator<std::pair<const Key, T>>>
+struct BPlusTreeMap {
+    static_assert(MaxNKeys >= 2 && MaxNElems >= 2);
+    static constexpr size_t MinNKeys = MaxNKeys / 2;
+    static constexpr size_t MinNElems = MaxNElems / 2;
+    static_assert(std::copyable<Key> && std::default_initializable<Key>);
+
+    using key_type = Key;
+    using mapped_type = T;
+    using key_compare = Compare;
+    using allocator_type = Allocator;
+
+    using value_type = std::pair<const Key, T>;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+
+    static_assert(std::is_same_v<typename collective_allocator_traits<allocator_type>::value_type, value_type>);
+
+    struct value_compare {
+    private:
+        friend struct BPlusTreeMap;
+        key_compare comp;
+        explicit value_compare(const key_compare& compare) : comp(compare) {}
+
+    public:
+        bool operator()(const value_type& lhs, const value_type& rhs) const
+        {
+            return comp(lhs.first, rhs.first);
+        }
+    };
+
+private:
+    using Leaf = BPlusTreeLeaf<typename collective_allocator_traits<allocator_type>::pointer, MaxNKeys, MaxNElems>;
+    using LeafTraits = typename collective_allocator_traits<allocator_type>::template rebind_traits<Leaf>;
+    using LeafAlloc = typename LeafTraits::allocator_type;
+    using LeafSuballocTraits = typename LeafTraits::suballocator_traits;
+    using LeafSuballoc = typename LeafSuballocTraits::allocator_type;
+
+    using Inner = BPlusTreeInner<typename collective_allocator_traits<allocator_type>::pointer, MaxNKeys, MaxNElems>;
+    using InnerTraits = typename collective_allocator_traits<allocator_type>::template rebind_traits<Inner>;
+    using InnerAlloc = typename InnerTraits::allocator_type;
+    using InnerSuballocTraits = typename InnerTraits::suballocator_traits;
+
+public:
+    using difference_type = std::common_type_t<typename LeafTraits::difference_type, ssize_t>;
+    using size_type = std::make_unsigned_t<difference_type>;
+
+    struct const_iterator : BPlusTreeIterBase<Leaf> {
+        using Base = BPlusTreeIterBase<Leaf>;
+
+        using itertor_concept = std::bidirectional_iterator_tag;
+        using difference_type = BPlusTreeMap::difference_type;
+        using value_type = typename Base::value_type;
+
+        const value_type& operator*() const noexcept { return *Base::get(); }
+        const value_type* operator->() const noexcept { return Base::get(); }
+
+        inline const_iterator& operator++();
+        inline const_iterator operator++(int);
+        inline const_iterator& operator--();
+        inline const_iterator operator--(int);
+    };
+    static_assert(std::bidirectional_iterator<const_iterator>);
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    struct iterator : BPlusTreeIterBase<Leaf> {
+        using Base = BPlusTreeIterBase<Leaf>;
+
+        using itertor_concept = std::bidirectional_iterator_tag;
+        using difference_type = BPlusTreeMap::difference_type;
+        using value_type = typename Base::value_type;
+
+        value_type& operator*() const noexcept { return *Base::get(); }
+        value_type* operator->() const noexcept { return Base::get(); }
+
+        operator const_iterator() const& noexcept { return const_iterator{Base{*this}}; }
+        operator const_iterator() && noexcept { return const_iterator{Base{std::move(*this)}}; }
+
+        inline iterator& operator++();
+        inline iterator operator++(int);
+        inline iterator& operator--();
+        inline iterator operator--(int);
+    };
+    static_assert(std::bidirectional_iterator<iterator>);
+    using reverse_iterator = std::reverse_iterator<iterator>;
+
+private:
+    using LeafPtr = typename Leaf::LeafPtr;
+    using InnerPtr = typename Leaf::InnerPtr;
+
+    size_type size_cnt = 0;
+    [[no_unique_address]] key_compare comp = Compare();
+    [[no_unique_address]] LeafAlloc leaf_alloc = allocator_type();
+    [[no_unique_address]] InnerAlloc inner_alloc = allocator_type();
+    // invariant: header->n_keys == 0 && header->parent == nullptr
+    // invariant: size_cnt == 0 || header->children[0] == (the root node)
+    InnerPtr header = [this] {
+        auto suballoc = InnerTraits::get_suballocator(inner_alloc, purely_local);
+        InnerPtr tmp = InnerSuballocTraits::allocate(suballoc, 1);
+        new (&(*tmp)) Inner{.n_keys = 0, .is_bottom = false, .keys = {}, .children = {}, .parent = nullptr};
+        return tmp;
+    }();
+    // the sentinel of the list of the leaves, pointed to by `end()`
+    LeafPtr end_leaf = [this] {
+        auto suballoc = LeafTraits::get_suballocator(leaf_alloc, purely_local);
+        LeafPtr tmp = LeafSuballocTraits::allocate(suballoc, 1);
+        new (&(*tmp)) Leaf{.n_elems = 0, .parent = header, .prev = tmp, .next = tmp};
+        return tmp;
+    }();
+
+public:
+    BPlusTreeMap() {}
+    BPlusTreeMap(const allocator_type& alloc) : leaf_alloc(alloc), inner_alloc(alloc) {}
+    inline ~BPlusTreeMap() noexcept;
+
+    iterator begin() noexcept { return iterator{{.leaf = end_leaf->next, .elem_idx = 0}}; }
+    const_iterator begin() const noexcept { return const_iterator{{.leaf = end_leaf->next, .elem_idx = 0}}; }
+    const_iterator cbegin() const noexcept { return begin(); }
+
+    iterator end() noexcept { return iterator{{.leaf = end_leaf, .elem_idx = 0}}; }
+    const_iterator end() const noexcept { return const_iterator{{.leaf = end_leaf, .elem_idx = 0}}; }
+    const_iterator cend() const noexcept { return end(); }
+
+    reverse_iterator rbegin() noexcept { return std::make_reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return std::make_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+    reverse_iterator rend() noexcept { return std::make_reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return std::make_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    size_type size() const noexcept { return size_cnt; }
+    bool empty() const noexcept { return size_cnt == 0; }
+
+    allocator_type get_allocator() const noexcept { return allocator_type(leaf_alloc); }
+
+    iterator find(const key_type& x) { return find_impl(x); }
+    const_iterator find(const key_type& x) const { return find_impl(x); }
+    //! calls `f` with at most `n` elements in ascending order from that of `from_key`, as `find(from_key)` followed by increments
+    //! Before the first leaf is swapped in, `prefetch(address, size)` is called for each of the swappable leaves following it,
+    //! as many as the rest of the scan would visit if they were minimally filled, so that swapping them in overlaps.
+    //! They are found in the inner nodes, and therefore no leaf is touched for it.
+    //! @return the number of the elements visited, 0 if `from_key` does not exist
+    template <class F, class Prefetch>
+    inline size_t scan(const key_type& from_key, size_t n, F&& f, Prefetch&& prefetch);
+
+    inline std::pair<iterator, bool> insert(value_type&& x);
+    inline size_type erase(const key_type& x);
+    //! replaces the mapped value of `x` if exists
+    //! @return whether `x` exists
+    inline bool update(const key_type& x, const mapped_type& obj);
+
+    inline void clear();
+
+    //! Relocates the leaves in ascending order of the keys into new pages, up to 70% of each,
+    //! so that a range scan swaps in consecutive pages and nothing but the leaves.
+    inline void batch_block();
+
+    //! @return [purely_local_inner_nodes, swappable_inner_nodes, leaves]
+    inline std::array<size_t, 3> count_nodes();
+
+private:
+    template <class K>
+    inline iterator find_impl(const K& x) const;
+    //! calls `prefetch` for the swappable leaves following `parent->children.leaves[idx]` which hold `n_elems` elements at least
+    template <class Prefetch>
+    inline void prefetch_leaves(InnerPtr parent, size_t idx, size_t n_elems, Prefetch& prefetch);
+
+
+    inline InnerPtr allocate_inner();
+    //! allocates a leaf in the same suballocator as `neighbor` if possible
+    inline LeafPtr allocate_leaf(const LeafPtr& neighbor);
+    inline void dispose(InnerPtr node);
+    inline void dispose(LeafPtr leaf);
+    //! relocates `leaf` into `suballoc`, and updates the pointers to it
+    //! @return whether `leaf` has been relocated, i.e., `suballoc` has had room for it
+    inline bool relocate(LeafPtr& leaf, LeafSuballoc suballoc);
+    //! relocates `leaf` next to the leaves relocated into `block` before, or into a new page if it does not fit
+    //! It stays where it is if it does not fit in a page at all.
+    inline void relocate_into_block(LeafPtr& leaf, LeafSuballoc& block);
+    inline void clear_step(InnerPtr node);
+    inline void count_nodes_step(InnerPtr node, std::array<size_t, 3>& acc);
+
+    struct InsertStepResult {
+        std::pair<iterator, bool> result;
+        // the smallest key in the new right sibling of the node, if the node has been split
+        std::optional<key_type> separator{};
+        InnerPtr new_inner = nullptr;
+        LeafPtr new_leaf = nullptr;
+
+        //! @return `new_leaf` or `new_inner`, whichever is of the type of the elements of `children`
+        template <class Children>
+        typename Children::value_type new_child(const Children&) const
+        {
+            if constexpr (std::is_same_v<typename Children::value_type, LeafPtr>) {
+                return new_leaf;
+            } else {
+                return new_inner;
+            }
+        }
+    };
+    inline InsertStepResult insert_step(value_type&& x, InnerPtr node);
+    inline InsertStepResult insert_to_leaf(value_type&& x, LeafPtr leaf);
+
+    inline size_type erase_step(const key_type& key, InnerPtr node);
+    inline size_type erase_from_leaf(const key_type& key, LeafPtr leaf);
+    //! lets `parent->children[idx]`, which has less elements/keys than the minimum, borrow one from or be merged with a sibling
+    inline void rebalance_leaf(InnerPtr parent, size_t idx);
+    inline void rebalance_inner(InnerPtr parent, size_t idx);
+    //! merges `parent->children[idx + 1]` into `parent->children[idx]`
+    inline void merge_leaves(InnerPtr parent, size_t idx);
+    inline void merge_inners(InnerPtr parent, size_t idx);
+    //! removes `parent->keys[idx]` and `parent->children[idx + 1]`
+    inline void remove_from_inner(InnerPtr parent, size_t idx);
+};
+
+}  // namespace Blocked
+}  // namespace FarMemoryContainer
+
+#include <far_memory_container/blocked/b_plus_tree_node.ipp>
+
+#include <far_memory_container/blocked/b_plus_tree_iterator.ipp>
+
+#include <far_memory_container/blocked/b_plus_tree.ipp>
@@ -0,0 +1,603 @@
+#pragma once
+
+#include <far_memory_container/blocked/b_plus_tree.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+namespace FarMemoryContainer::Blocked
+{
+
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::~BPlusTreeMap() noexcept
+{
+    clear();
+
+    header->~Inner();
+    InnerTraits::deallocate(inner_alloc, std::move(header), 1);
+    end_leaf->~Leaf();
+    LeafTraits::deallocate(leaf_alloc, std::move(end_leaf), 1);
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+void BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::clear()
+{
+    if (size_cnt != 0 && !header->is_bottom) {
+        clear_step(header->children.inner[0]);
+    }
+    LeafPtr leaf = end_leaf->next;
+    while (leaf != end_leaf) {
+        LeafPtr deleted = std::move(leaf);
+        Leaf& leaf_ref = *deleted;
+        leaf = leaf_ref.next;
+        for (size_t i = 0; i != leaf_ref.n_elems; i++) {
+            leaf_ref.elems[i].destroy(leaf_alloc);
+        }
+        dispose(std::move(deleted));
+    }
+    header->is_bottom = false;
+    header->children = {};
+    end_leaf->prev = end_leaf->next = end_leaf;
+
+    size_cnt = 0;
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+void BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::clear_step(InnerPtr node)
+{
+    // the leaves are destroyed along the list
+    if (!node->is_bottom) {
+        for (size_t i = 0; i <= node->n_keys; i++) {
+            clear_step(node->children.inner[i]);
+        }
+    }
+    dispose(std::move(node));
+}
+
+
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+template <class K>
+auto BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::find_impl(const K& x) const -> iterator
+{
+    if (size_cnt == 0) {
+        return iterator{{.leaf = end_leaf, .elem_idx = 0}};
+    }
+
+    // Only the leaf is possibly swapped out.
+    InnerPtr node = header;
+    while (!node->is_bottom) {
+        node = node->children.inner[node->upper_bound(x, comp)];
+    }
+    LeafPtr leaf = node->children.leaves[node->upper_bound(x, comp)];
+
+    const auto upper_bound = leaf->upper_bound(x, comp);
+    if (upper_bound == 0 || comp(leaf->elems[upper_bound - 1].get()->first, x)) {
+        return iterator{{.leaf = end_leaf, .elem_idx = 0}};
+    }
+    return iterator{{.leaf = std::move(leaf), .elem_idx = upper_bound - 1}};
+}
+
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+template <class F, class Prefetch>
+size_t BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::scan(const key_type& from_key, const size_t n, F&& f, Prefetch&& prefetch)
+{
+    if (size_cnt == 0 || n == 0) {
+        return 0;
+    }
+
+    InnerPtr parent = header;
+    while (!parent->is_bottom) {
+        parent = parent->children.inner[parent->upper_bound(from_key, comp)];
+    }
+    const size_t idx = parent->upper_bound(from_key, comp);
+    // assuming the first leaf has only the element of `from_key` to visit
+    prefetch_leaves(parent, idx, n - 1, prefetch);
+
+    LeafPtr leaf = parent->children.leaves[idx];
+    const auto upper_bound = leaf->upper_bound(from_key, comp);
+    if (upper_bound == 0 || comp(leaf->elems[upper_bound - 1].get()->first, from_key)) {
+        return 0;
+    }
+    size_t cnt = 0;
+    for (iterator iter{{.leaf = std::move(leaf), .elem_idx = upper_bound - 1}}; cnt != n && iter != end(); cnt++, ++iter) {
+        f(*iter);
+    }
+    return cnt;
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+template <class Prefetch>
+void BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::prefetch_leaves(InnerPtr parent, size_t idx, size_t n_elems, Prefetch& prefetch)
+{
+    auto local = LeafTraits::get_suballocator(leaf_alloc, purely_local);
+    while (n_elems != 0) {
+        if (idx == parent->n_keys) {
+            // the first leaf in the next subtree of the lowest ancestor having it
+            InnerPtr node = std::move(parent);
+            for (;;) {
+                if (/* header */ node->parent == nullptr) {
+                    return;
+                }
+                InnerPtr upper = node->parent;
+                const size_t node_idx = std::ranges::find(upper->children.inner, node) - upper->children.inner.begin();
+                if (node_idx != upper->n_keys) {
+                    node = upper->children.inner[node_idx + 1];
+                    break;
+                }
+                node = std::move(upper);
+            }
+            while (!node->is_bottom) {
+                node = node->children.inner[0];
+            }
+            parent = std::move(node);
+            idx = 0;
+        } else {
+            idx++;
+        }
+
+        const LeafPtr& leaf = parent->children.leaves[idx];
+        n_elems -= std::min(n_elems, MinNElems);
+        if (!LeafTraits::if_suballocator_contains(leaf_alloc, local, leaf)) {
+            prefetch(static_cast<const void*>(&(*leaf)), sizeof(Leaf));
+        }
+    }
+}
+
+
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+auto BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::allocate_inner() -> InnerPtr
+{
+    auto suballoc = InnerTraits::get_suballocator(inner_alloc, purely_local);
+    auto allocated = InnerSuballocTraits::batch_allocate(suballoc, request::single<Inner>());
+    if (!allocated) {
+        suballoc = InnerTraits::get_suballocator(inner_alloc, swappable_plain);
+        allocated = InnerSuballocTraits::batch_allocate(suballoc, request::single<Inner>());
+    }
+    if (!allocated) {
+        throw std::bad_alloc{};
+    }
+    return std::get<0>(*allocated);
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+auto BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::allocate_leaf(const LeafPtr& neighbor) -> LeafPtr
+{
+    auto suballoc = (neighbor == nullptr ? LeafTraits::get_suballocator(leaf_alloc, swappable_plain) : LeafTraits::get_suballocator(leaf_alloc, neighbor));
+    auto allocated = LeafSuballocTraits::batch_allocate(suballoc, request::single<Leaf>());
+    if (!allocated) {
+        suballoc = LeafTraits::get_suballocator(leaf_alloc, swappable_plain);
+        allocated = LeafSuballocTraits::batch_allocate(suballoc, request::single<Leaf>());
+    }
+    if (!allocated) {
+        throw std::bad_alloc{};
+    }
+    return std::get<0>(*allocated);
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+void BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::dispose(InnerPtr node)
+{
+    node->~Inner();
+    InnerTraits::deallocate(inner_alloc, std::move(node), 1);
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+void BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::dispose(LeafPtr leaf)
+{
+    leaf->~Leaf();
+    LeafTraits::deallocate(leaf_alloc, std::move(leaf), 1);
+}
+
+
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+auto BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::insert(value_type&& x) -> std::pair<iterator, bool>
+{
+    if (/* first element */ size_cnt == 0) {
+        LeafPtr root = allocate_leaf(nullptr);
+        new (&(*root)) Leaf{.n_elems = 1, .parent = header, .prev = end_leaf, .next = end_leaf};
+        root->elems[0].construct(leaf_alloc, std::move(x));
+
+        end_leaf->prev = end_leaf->next = root;
+        header->is_bottom = true;
+        header->children.leaves[0] = root;
+        size_cnt = 1;
+
+        return {{{.leaf = std::move(root), .elem_idx = 0}}, true};
+    }
+
+    auto res = (header->is_bottom ? insert_to_leaf(std::move(x), header->children.leaves[0]) : insert_step(std::move(x), header->children.inner[0]));
+    if (/* the root has been split */ res.separator) {
+        InnerPtr root = allocate_inner();
+        new (&(*root)) Inner{.n_keys = 1, .is_bottom = header->is_bottom, .keys = {*std::move(res.separator)}, .children = {}, .parent = header};
+        root->visit_children(*header, [&](auto& children, auto& old_root) {
+            children[0] = old_root[0];
+            children[1] = res.new_child(children);
+            children[0]->parent = children[1]->parent = root;
+        });
+
+        header->is_bottom = false;
+        header->children.inner[0] = root;
+    }
+    return res.result;
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+auto BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::insert_step(value_type&& x, InnerPtr node) -> InsertStepResult
+{
+    const auto upper_bound = node->upper_bound(x.first, comp);
+    auto res = (node->is_bottom ? insert_to_leaf(std::move(x), node->children.leaves[upper_bound]) : insert_step(std::move(x), node->children.inner[upper_bound]));
+    if (/* the child has not been split */ !res.separator) {
+        return res;
+    }
+
+    if (/* not full */ node->n_keys != MaxNKeys) {
+        node->visit_children([&](auto& children) {
+            for (size_t i = node->n_keys; i != upper_bound; i--) {
+                node->keys[i] = std::move(node->keys[i - 1]);
+                children[i + 1] = std::move(children[i]);
+            }
+            node->keys[upper_bound] = *std::move(res.separator);
+            children[upper_bound + 1] = res.new_child(children);
+        });
+        node->n_keys++;
+
+        res.separator.reset();
+        res.new_inner = nullptr;
+        res.new_leaf = nullptr;
+        return res;
+    }
+
+    // Of the `MaxNKeys + 1` keys, the first `n_left` ones are left in this node, and the next one is pushed up.
+    constexpr size_t n_left = (MaxNKeys + 1) / 2;
+    InnerPtr new_node = allocate_inner();
+    new (&(*new_node)) Inner{.n_keys = MaxNKeys - n_left, .is_bottom = node->is_bottom, .keys = {}, .children = {}, .parent = node->parent};
+
+    node->visit_children(*new_node, [&](auto& children, auto& new_children) {
+        std::array<key_type, MaxNKeys + 1> keys;
+        std::array<typename std::remove_reference_t<decltype(children)>::value_type, MaxNKeys + 2> all_children;
+        std::move(node->keys.begin(), node->keys.begin() + upper_bound, keys.begin());
+        keys[upper_bound] = *std::move(res.separator);
+        std::move(node->keys.begin() + upper_bound, node->keys.end(), keys.begin() + upper_bound + 1);
+        std::copy(children.begin(), children.begin() + upper_bound + 1, all_children.begin());
+        all_children[upper_bound + 1] = res.new_child(children);
+        std::copy(children.begin() + upper_bound + 1, children.end(), all_children.begin() + upper_bound + 2);
+
+        std::move(keys.begin(), keys.begin() + n_left, node->keys.begin());
+        std::copy(all_children.begin(), all_children.begin() + n_left + 1, children.begin());
+        std::fill(children.begin() + n_left + 1, children.end(), nullptr);
+        res.separator = std::move(keys[n_left]);
+        std::move(keys.begin() + n_left + 1, keys.end(), new_node->keys.begin());
+        std::copy(all_children.begin() + n_left + 1, all_children.end(), new_children.begin());
+        for (size_t i = 0; i <= new_node->n_keys; i++) {
+            new_children[i]->parent = new_node;
+        }
+    });
+    node->n_keys = n_left;
+
+    res.new_inner = new_node;
+    res.new_leaf = nullptr;
+    return res;
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+auto BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::insert_to_leaf(value_type&& x, LeafPtr leaf) -> InsertStepResult
+{
+    const auto upper_bound = leaf->upper_bound(x.first, comp);
+    if (/* already exists */ upper_bound != 0 && !comp(leaf->elems[upper_bound - 1].get()->first, x.first)) {
+        return {.result = {{{.leaf = std::move(leaf), .elem_idx = upper_bound - 1}}, false}};
+    }
+    size_cnt++;
+
+    if (/* not full */ leaf->n_elems != MaxNElems) {
+        for (size_t i = leaf->n_elems; i != upper_bound; i--) {
+            leaf->elems[i].move_from(leaf_alloc, leaf->elems[i - 1]);
+        }
+        leaf->elems[upper_bound].construct(leaf_alloc, std::move(x));
+        leaf->n_elems++;
+
+        return {.result = {{{.leaf = std::move(leaf), .elem_idx = upper_bound}}, true}};
+    }
+
+    // Of the `MaxNElems + 1` elements, the first `n_left` ones are left in this leaf, and the others are moved to the new leaf.
+    // The new leaf is allocated next to this leaf if possible, so that a range read touches less pages.
+    constexpr size_t n_left = (MaxNElems + 2) / 2;
+    LeafPtr new_leaf = allocate_leaf(leaf);
+    new (&(*new_leaf)) Leaf{.n_elems = MaxNElems + 1 - n_left, .parent = leaf->parent, .prev = leaf, .next = leaf->next};
+    leaf->next = new_leaf->next->prev = new_leaf;
+
+    for (size_t i = n_left; i <= MaxNElems; i++) {
+        if (i == upper_bound) {
+            new_leaf->elems[i - n_left].construct(leaf_alloc, std::move(x));
+        } else {
+            new_leaf->elems[i - n_left].move_from(leaf_alloc, leaf->elems[i < upper_bound ? i : i - 1]);
+        }
+    }
+    if (/* inserted to the original leaf */ upper_bound < n_left) {
+        for (size_t i = n_left - 1; i != upper_bound; i--) {
+            leaf->elems[i].move_from(leaf_alloc, leaf->elems[i - 1]);
+        }
+        leaf->elems[upper_bound].construct(leaf_alloc, std::move(x));
+    }
+    leaf->n_elems = n_left;
+
+    return {
+        .result = {upper_bound < n_left ? iterator{{.leaf = leaf, .elem_idx = upper_bound}} : iterator{{.leaf = new_leaf, .elem_idx = upper_bound - n_left}}, true},
+        .separator = new_leaf->elems[0].get()->first,
+        .new_inner = nullptr,
+        .new_leaf = new_leaf,
+    };
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+bool BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::update(const key_type& x, const mapped_type& obj)
+{
+    auto iter = find_impl(x);
+    if (iter == end()) {
+        return false;
+    }
+    iter->second = obj;
+    return true;
+}
+
+
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+auto BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::erase(const key_type& key) -> size_type
+{
+    if (size_cnt == 0) {
+        return 0;
+    }
+
+    if (/* the root is a leaf */ header->is_bottom) {
+        LeafPtr root = header->children.leaves[0];
+        const auto result = erase_from_leaf(key, root);
+        if (/* the last element has been erased */ root->n_elems == 0) {
+            end_leaf->prev = end_leaf->next = end_leaf;
+            header->is_bottom = false;
+            header->children.inner[0] = nullptr;
+            dispose(std::move(root));
+        }
+        return result;
+    }
+
+    InnerPtr root = header->children.inner[0];
+    const auto result = erase_step(key, root);
+    if (/* the root has a single child */ root->n_keys == 0) {
+        header->is_bottom = root->is_bottom;
+        header->children = root->children;
+        header->visit_children([this](auto& children) {
+            children[0]->parent = header;
+        });
+        dispose(std::move(root));
+    }
+    return result;
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+auto BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::erase_step(const key_type& key, InnerPtr node) -> size_type
+{
+    const auto upper_bound = node->upper_bound(key, comp);
+    if (node->is_bottom) {
+        const auto result = erase_from_leaf(key, node->children.leaves[upper_bound]);
+        if (result != 0 && node->children.leaves[upper_bound]->n_elems < MinNElems) {
+            rebalance_leaf(node, upper_bound);
+        }
+        return result;
+    }
+
+    const auto result = erase_step(key, node->children.inner[upper_bound]);
+    if (result != 0 && node->children.inner[upper_bound]->n_keys < MinNKeys) {
+        rebalance_inner(node, upper_bound);
+    }
+    return result;
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+auto BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::erase_from_leaf(const key_type& key, LeafPtr leaf) -> size_type
+{
+    const auto upper_bound = leaf->upper_bound(key, comp);
+    if (/* not found */ upper_bound == 0 || comp(leaf->elems[upper_bound - 1].get()->first, key)) {
+        return 0;
+    }
+
+    leaf->elems[upper_bound - 1].destroy(leaf_alloc);
+    for (size_t i = upper_bound; i != leaf->n_elems; i++) {
+        leaf->elems[i - 1].move_from(leaf_alloc, leaf->elems[i]);
+    }
+    leaf->n_elems--;
+    size_cnt--;
+    return 1;
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+void BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::rebalance_leaf(InnerPtr parent, const size_t idx)
+{
+    LeafPtr leaf = parent->children.leaves[idx];
+
+    if (idx != 0) {
+        LeafPtr prev = parent->children.leaves[idx - 1];
+        if (prev->n_elems != MinNElems) {
+            for (size_t i = leaf->n_elems; i != 0; i--) {
+                leaf->elems[i].move_from(leaf_alloc, leaf->elems[i - 1]);
+            }
+            leaf->elems[0].move_from(leaf_alloc, prev->elems[prev->n_elems - 1]);
+            prev->n_elems--;
+            leaf->n_elems++;
+            parent->keys[idx - 1] = leaf->elems[0].get()->first;
+            return;
+        }
+    }
+
+    if (idx != parent->n_keys) {
+        LeafPtr next = parent->children.leaves[idx + 1];
+        if (next->n_elems != MinNElems) {
+            leaf->elems[leaf->n_elems].move_from(leaf_alloc, next->elems[0]);
+            for (size_t i = 1; i != next->n_elems; i++) {
+                next->elems[i - 1].move_from(leaf_alloc, next->elems[i]);
+            }
+            next->n_elems--;
+            leaf->n_elems++;
+            parent->keys[idx] = next->elems[0].get()->first;
+            return;
+        }
+    }
+
+    merge_leaves(parent, idx != 0 ? idx - 1 : idx);
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+void BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::rebalance_inner(InnerPtr parent, const size_t idx)
+{
+    InnerPtr node = parent->children.inner[idx];
+
+    if (idx != 0) {
+        InnerPtr prev = parent->children.inner[idx - 1];
+        if (prev->n_keys != MinNKeys) {
+            node->visit_children(*prev, [&](auto& children, auto& prev_children) {
+                for (size_t i = node->n_keys; i != 0; i--) {
+                    node->keys[i] = std::move(node->keys[i - 1]);
+                    children[i + 1] = std::move(children[i]);
+                }
+                children[1] = std::move(children[0]);
+                node->keys[0] = std::move(parent->keys[idx - 1]);
+                children[0] = std::exchange(prev_children[prev->n_keys], nullptr);
+                children[0]->parent = node;
+            });
+            parent->keys[idx - 1] = std::move(prev->keys[prev->n_keys - 1]);
+            prev->n_keys--;
+            node->n_keys++;
+            return;
+        }
+    }
+
+    if (idx != parent->n_keys) {
+        InnerPtr next = parent->children.inner[idx + 1];
+        if (next->n_keys != MinNKeys) {
+            node->visit_children(*next, [&](auto& children, auto& next_children) {
+                node->keys[node->n_keys] = std::move(parent->keys[idx]);
+                children[node->n_keys + 1] = std::move(next_children[0]);
+                children[node->n_keys + 1]->parent = node;
+                for (size_t i = 1; i <= next->n_keys; i++) {
+                    next_children[i - 1] = std::move(next_children[i]);
+                }
+                next_children[next->n_keys] = nullptr;
+            });
+            parent->keys[idx] = std::move(next->keys[0]);
+            for (size_t i = 1; i != next->n_keys; i++) {
+                next->keys[i - 1] = std::move(next->keys[i]);
+            }
+            next->n_keys--;
+            node->n_keys++;
+            return;
+        }
+    }
+
+    merge_inners(parent, idx != 0 ? idx - 1 : idx);
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+void BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::merge_leaves(InnerPtr parent, const size_t idx)
+{
+    LeafPtr leaf = parent->children.leaves[idx], next = parent->children.leaves[idx + 1];
+
+    for (size_t i = 0; i != next->n_elems; i++) {
+        leaf->elems[leaf->n_elems + i].move_from(leaf_alloc, next->elems[i]);
+    }
+    leaf->n_elems += next->n_elems;
+    next->next->prev = leaf;
+    leaf->next = next->next;
+
+    remove_from_inner(std::move(parent), idx);
+    dispose(std::move(next));
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+void BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::merge_inners(InnerPtr parent, const size_t idx)
+{
+    InnerPtr node = parent->children.inner[idx], next = parent->children.inner[idx + 1];
+
+    node->keys[node->n_keys] = std::move(parent->keys[idx]);
+    for (size_t i = 0; i != next->n_keys; i++) {
+        node->keys[node->n_keys + 1 + i] = std::move(next->keys[i]);
+    }
+    node->visit_children(*next, [&](auto& children, auto& next_children) {
+        for (size_t i = 0; i <= next->n_keys; i++) {
+            children[node->n_keys + 1 + i] = std::move(next_children[i]);
+            children[node->n_keys + 1 + i]->parent = node;
+        }
+    });
+    node->n_keys += 1 + next->n_keys;
+
+    remove_from_inner(std::move(parent), idx);
+    dispose(std::move(next));
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+void BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::remove_from_inner(InnerPtr parent, const size_t idx)
+{
+    parent->visit_children([&](auto& children) {
+        for (size_t i = idx + 1; i != parent->n_keys; i++) {
+            parent->keys[i - 1] = std::move(parent->keys[i]);
+            children[i] = std::move(children[i + 1]);
+        }
+        children[parent->n_keys] = nullptr;
+    });
+    parent->n_keys--;
+}
+
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+bool BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::relocate(LeafPtr& leaf, LeafSuballoc suballoc)
+{
+    const auto child_iter_to_leaf = std::ranges::find(leaf->parent->children.leaves, leaf);
+
+    if (!LeafTraits::relocate(
+            leaf_alloc, suballoc, [this](Leaf* from, auto, Leaf* to) {
+                new (to) Leaf{.n_elems = from->n_elems, .parent = from->parent, .prev = from->prev, .next = from->next};
+                for (size_t i = 0; i != to->n_elems; i++) {
+                    to->elems[i].move_from(leaf_alloc, from->elems[i]);
+                }
+                from->~Leaf();
+            },
+            std::tie(leaf), request::single<Leaf>())) {
+        return false;
+    }
+
+    *child_iter_to_leaf = leaf;
+    leaf->prev->next = leaf->next->prev = leaf;
+    return true;
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+void BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::relocate_into_block(LeafPtr& leaf, LeafSuballoc& block)
+{
+    PageAwarePlacement::relocate_by<LeafTraits>(leaf_alloc, block, [&](LeafSuballoc& suballoc) { return relocate(leaf, suballoc); });
+}
+
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+void BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::batch_block()
+{
+    auto block = LeafTraits::get_suballocator(leaf_alloc, new_per_page);
+    // The leaves are visited through the links, which only the inner nodes point to besides.
+    for (LeafPtr leaf = end_leaf->next; leaf != end_leaf; leaf = leaf->next) {
+        relocate_into_block(leaf, block);
+    }
+}
+
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+std::array<size_t, 3> BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::count_nodes()
+{
+    std::array<size_t, 3> res{};
+    if (size_cnt != 0) {
+        if (header->is_bottom) {
+            res[2] = 1;
+        } else {
+            count_nodes_step(header->children.inner[0], res);
+        }
+    }
+    return res;
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+void BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::count_nodes_step(InnerPtr node, std::array<size_t, 3>& acc)
+{
+    auto local = InnerTraits::get_suballocator(inner_alloc, purely_local);
+    acc[InnerTraits::if_suballocator_contains(inner_alloc, local, node) ? 0 : 1]++;
+    if (node->is_bottom) {
+        acc[2] += node->n_keys + 1;
+    } else {
+        for (size_t i = 0; i <= node->n_keys; i++) {
+            count_nodes_step(node->children.inner[i], acc);
+        }
+    }
+}
+
+}  // namespace FarMemoryContainer::Blocked
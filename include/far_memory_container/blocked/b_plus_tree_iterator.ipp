@@ -0,0 +1,87 @@
+#pragma once
+
+#include <far_memory_container/blocked/b_plus_tree.hpp>
+
+#include <cstddef>
+
+
+namespace FarMemoryContainer::Blocked
+{
+
+// Neither of them touches the inner nodes.
+template <class Leaf>
+void BPlusTreeIterBase<Leaf>::increment()
+{
+    elem_idx++;
+    if (elem_idx == leaf->n_elems) {  // having been pointing to the last element of a leaf
+        leaf = leaf->next;
+        elem_idx = 0;
+    }
+}
+
+template <class Leaf>
+void BPlusTreeIterBase<Leaf>::decrement()
+{
+    if (elem_idx == 0) {  // pointing to the first element of a leaf, or the sentinel
+        leaf = leaf->prev;
+        elem_idx = leaf->n_elems;
+    }
+    elem_idx--;
+}
+
+
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+auto BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::iterator::operator++() -> iterator&
+{
+    Base::increment();
+    return *this;
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+auto BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::iterator::operator++(int) -> iterator
+{
+    auto tmp = *this;
+    ++(*this);
+    return tmp;
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+auto BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::iterator::operator--() -> iterator&
+{
+    Base::decrement();
+    return *this;
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+auto BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::iterator::operator--(int) -> iterator
+{
+    auto tmp = *this;
+    --(*this);
+    return tmp;
+}
+
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+auto BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::const_iterator::operator++() -> const_iterator&
+{
+    Base::increment();
+    return *this;
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+auto BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::const_iterator::operator++(int) -> const_iterator
+{
+    auto tmp = *this;
+    ++(*this);
+    return tmp;
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+auto BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::const_iterator::operator--() -> const_iterator&
+{
+    Base::decrement();
+    return *this;
+}
+template <class Key, class T, size_t MaxNKeys, size_t MaxNElems, class Compare, class Allocator>
+auto BPlusTreeMap<Key, T, MaxNKeys, MaxNElems, Compare, Allocator>::const_iterator::operator--(int) -> const_iterator
+{
+    auto tmp = *this;
+    --(*this);
+    return tmp;
+}
+
+}  // namespace FarMemoryContainer::Blocked
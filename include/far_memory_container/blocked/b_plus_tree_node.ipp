@@ -0,0 +1,53 @@
+#pragma once
+
+#include <far_memory_container/blocked/b_plus_tree.hpp>
+
+#include <bit>
+#include <cstddef>
+#include <utility>
+
+
+namespace FarMemoryContainer::Blocked
+{
+
+template <class PtrToVal, size_t MaxNKeys, size_t MaxNElems>
+template <class Key, class key_compare>
+size_t BPlusTreeLeaf<PtrToVal, MaxNKeys, MaxNElems>::upper_bound(const Key& key, key_compare& comp) const
+{
+    if (n_elems == 0) {
+        return 0;
+    }
+    const auto num_comp = std::bit_width(n_elems);
+    const size_t first_idx = n_elems - (size_t(1) << (num_comp - 1));
+    size_t pos = (comp(key, elems[first_idx].get()->first) ? 0 : first_idx + 1);
+
+    for (size_t i = num_comp - 1; i != 0; i--) {
+        const size_t step = size_t(1) << (i - 1);
+        pos = (comp(key, elems[pos + step - 1].get()->first) ? pos : pos + step);
+    }
+
+    return pos;
+}
+
+template <class PtrToVal, size_t MaxNKeys, size_t MaxNElems>
+template <class F>
+void BPlusTreeInner<PtrToVal, MaxNKeys, MaxNElems>::visit_children(F&& f)
+{
+    if (is_bottom) {
+        std::forward<F>(f)(children.leaves);
+    } else {
+        std::forward<F>(f)(children.inner);
+    }
+}
+template <class PtrToVal, size_t MaxNKeys, size_t MaxNElems>
+template <class F>
+void BPlusTreeInner<PtrToVal, MaxNKeys, MaxNElems>::visit_children(BPlusTreeInner& sibling, F&& f)
+{
+    if (is_bottom) {
+        std::forward<F>(f)(children.leaves, sibling.children.leaves);
+    } else {
+        std::forward<F>(f)(children.inner, sibling.children.inner);
+    }
+}
+
+}  // namespace FarMemoryContainer::Blocked
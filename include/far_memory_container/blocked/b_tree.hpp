@@ -2,6 +2,13 @@
 
 #include <farmalloc/collective_allocator_traits.hpp>
 #include <far_memory_container/aligned_buffer.hpp>
+#include <far_memory_container/epoch_based_reclamation.hpp>
+#include <far_memory_container/interleaved_lookup.hpp>
+#include <far_memory_container/key_search.hpp>
+#include <far_memory_container/optimistic_lock.hpp>
+#include <far_memory_container/out_of_line_element.hpp>
+#include <far_memory_container/page_cache_simulator.hpp>
+#include <far_memory_container/placement.hpp>
 #include <util/enough_unsigned_integer.hpp>
 
 #include <algorithm>
@@ -11,10 +18,16 @@
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <new>
 #include <optional>
+#include <ranges>
+#include <span>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include <variant>
+#include <vector>
 
 
 namespace FarMemoryContainer
@@ -25,22 +38,35 @@ using namespace FarMalloc;
 namespace Blocked
 {
 
-template <class PtrToVal, size_t MaxNElems>
+template <class PtrToVal, size_t MaxNElems, bool Concurrent = false, bool SeparateKeys = false, bool OutOfLineValues = false>
 struct BTreeNode {
     using value_type = std::remove_reference_t<decltype(*std::declval<PtrToVal>())>;
+    using key_type = std::remove_const_t<typename value_type::first_type>;
     using NodePtr = typename std::pointer_traits<PtrToVal>::template rebind<BTreeNode>;
+    using ElemBuffer = std::conditional_t<OutOfLineValues, OutOfLineElement<PtrToVal>, AlignedBuffer<value_type>>;
 
     size_t n_elems;
+    // copies of the keys of `elems`, next to `n_elems` so that a search touches one or two cache lines (only if `SeparateKeys`)
+    [[no_unique_address]] std::conditional_t<SeparateKeys, KeyArray<key_type, MaxNElems>, NoKeyArray> keys{};
     std::array<NodePtr, MaxNElems + 1> children;
     NodePtr parent;
     // All the nodes in a tree also compose a doubly-linked list.
     // The first and the last are *header, the second is the root if exists, and the other nodes follow in ascending order of depth.
     // The nodes with the same depth are ordered by the key.
     NodePtr prev, next;
-    std::array<AlignedBuffer<value_type>, MaxNElems> elems{};
+    std::array<ElemBuffer, MaxNElems> elems{};
+    [[no_unique_address]] std::conditional_t<Concurrent, OptimisticVersion, NoVersion> version{};
 
+    //! the key of `elems[idx]`, read without touching the element itself if possible
+    inline const key_type& key(size_t idx) const;
+
+    template <class Key, class key_compare>
+    inline size_t upper_bound(const Key& key, key_compare& comp) const { return upper_bound(key, comp, n_elems); }
+    //! for the optimistic readers, which must not re-read `n_elems` being modified concurrently
     template <class Key, class key_compare>
-    inline size_t upper_bound(const Key& key, key_compare& comp) const;
+    inline size_t upper_bound(const Key& key, key_compare& comp, size_t n) const;
+    //! copies the keys of `elems` to `keys` after they are modified, if `SeparateKeys`
+    inline void refresh_keys();
 };
 
 template <class Node>
@@ -59,10 +85,25 @@ struct BTreeIterBase {
     inline void decrement();
 };
 
-template <class Key, class T, size_t MaxNElems, class Compare = std::less<Key>, class Allocator = std::allocator<std::pair<const Key, T>>>
+//! @tparam Concurrent enables `lookup()` concurrent with the other operations, by optimistic lock coupling.
+//! The readers in `lookup()` descend without any lock, and validate the version counters of the nodes.
+//! The writers are serialized, and latch the nodes they modify until the end of the operation.
+//! The nodes unlinked by the writers, e.g., relocated ones, are reclaimed after the readers leave them.
+//! The other readers, i.e., `find()` and the iterators, are not protected against the writers.
+//! @tparam SeparateKeys lays out the keys of each node contiguously apart from the values, in addition to the elements.
+//! A search in a node then touches one or two cache lines regardless of `MaxNElems`, and uses SIMD instructions for integral keys.
+//! @tparam OutOfLineValues allocates each element apart from the nodes in the swappable region, and keeps a copy of its key in the node.
+//! The nodes then hold only the keys and the pointers, so that much more of the tree fits in the purely local region.
+//! `batch_block()`, `batch_vEB()`, and the bulk loading pack the elements in pages in key order,
+//! and `pin()` moves the elements of the hot keys into the purely local region.
+template <class Key, class T, size_t MaxNElems, class Compare = std::less<Key>, class Allocator = std::allocator<std::pair<const Key, T>>, bool Concurrent = false, bool SeparateKeys = false, bool OutOfLineValues = false>
 struct BTreeMap {
     static_assert(MaxNElems >= 2);
     static constexpr size_t MinNElems = MaxNElems / 2;
+    // The optimistic readers may copy an element being overwritten, and discard it after failing validation.
+    static_assert(!Concurrent || (std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<T>));
+    // The elements out of line are not protected against the writers by the epochs, unlike the nodes.
+    static_assert(!(Concurrent && OutOfLineValues));
 
     using key_type = Key;
     using mapped_type = T;
@@ -89,11 +130,15 @@ struct BTreeMap {
     };
 
 private:
-    using Node = BTreeNode<typename collective_allocator_traits<allocator_type>::pointer, MaxNElems>;
+    using Node = BTreeNode<typename collective_allocator_traits<allocator_type>::pointer, MaxNElems, Concurrent, SeparateKeys, OutOfLineValues>;
+    using ElemBuffer = typename Node::ElemBuffer;
     using AllocTraits = typename collective_allocator_traits<allocator_type>::template rebind_traits<Node>;
     using Alloc = typename AllocTraits::allocator_type;
     using SuballocTraits = typename AllocTraits::suballocator_traits;
     using Suballoc = typename SuballocTraits::allocator_type;
+    // for the elements out of line (only if `OutOfLineValues`)
+    using ValueAllocTraits = collective_allocator_traits<allocator_type>;
+    using ValueSuballoc = typename ValueAllocTraits::suballocator_traits::allocator_type;
 
 public:
     using difference_type = std::common_type_t<typename AllocTraits::difference_type, ssize_t>;
@@ -127,8 +172,8 @@ public:
         value_type& operator*() const noexcept { return *Base::get(); }
         value_type* operator->() const noexcept { return Base::get(); }
 
-        operator const_iterator() const& noexcept { return *this; }
-        operator const_iterator() && noexcept { return *this; }
+        operator const_iterator() const& noexcept { return const_iterator{Base{*this}}; }
+        operator const_iterator() && noexcept { return const_iterator{Base{std::move(*this)}}; }
 
         inline iterator& operator++();
         inline iterator operator++(int);
@@ -155,6 +200,37 @@ private:
     }();
     NodePtr begin_node = header;
     NodePtr last_local_node = header;
+    // the nodes to move into the local prefix after an erasure, one for each local node merged during it
+    // They are moved after the path of the erasure is fixed, as the parent of a merged node may be one of them.
+    size_t n_pending_local_refills = 0;
+
+    // incremental blocking (disabled while `reblocking_period == 0`)
+    size_t reblocking_period = 0;
+    size_t reblocking_height = 0;
+    bool reblocking_vEB = false;
+    size_t n_mutations_since_reblocking = 0;
+    // (a key in the node, height of the node) for each node split, merged, or evicted from the purely local region
+    std::vector<std::pair<key_type, size_t>> touched_nodes;
+
+    // promotion of hot nodes (disabled while `promotion_period == 0`)
+    size_t promotion_period = 0;
+    size_t promotion_sampling_interval = 1;
+    size_t promotion_max_swaps = 0;
+    mutable size_t n_lookups_since_sampling = 0;
+    mutable size_t n_sampled_lookups = 0;
+    struct AccessRecord {
+        NodePtr node;
+        size_t cnt;     // the sampled visits, halved every round
+        bool promoted;  // whether the node has been relocated into the purely local region out of the local prefix of the list
+    };
+    // for the nodes visited by the sampled lookups and the promoted nodes, keyed by the address
+    mutable std::unordered_map<const Node*, AccessRecord> access_records;
+
+    // concurrency control (only if `Concurrent`)
+    [[no_unique_address]] std::conditional_t<Concurrent, std::mutex, std::monostate> writer_mutex;
+    // the nodes latched by the running writer, which are unlatched at the end of the operation
+    std::vector<NodePtr> latched_nodes;
+    [[no_unique_address]] mutable std::conditional_t<Concurrent, EpochManager, std::monostate> epoch_manager;
 
 public:
     BTreeMap() {}
@@ -180,35 +256,147 @@ public:
     size_type size() const noexcept { return size_cnt; }
     inline size_type max_size();
     bool empty() const noexcept { return size_cnt == 0; }
+    //! the number of the nodes on a path from the root to a leaf, 0 if empty
+    inline size_t height() const noexcept;
 
     allocator_type get_allocator() const noexcept { return allocator_type(alloc); }
 
-    iterator find(const key_type& x) { return find_impl(x); }
+    iterator find(const key_type& x)
+    {
+        promote_if_due();
+        return find_impl(x);
+    }
     const_iterator find(const key_type& x) const { return find_impl(x); }
+    //! search from `hint`, e.g., the result of the previous lookup
+    //! It climbs from the node of `hint` only until a node whose elements enclose `x`, and descends from there,
+    //! so that the nodes touched are logarithmic in the distance to the result, not in the size.
+    //! @return the first element not less than `x`
+    inline iterator lower_bound(const_iterator hint, const key_type& x);
+    inline iterator find(const_iterator hint, const key_type& x);
+    //! @return a copy of the mapped value of `x`, safe against the concurrent writers if `Concurrent`
+    inline std::optional<mapped_type> lookup(const key_type& x) const;
+    //! calls `f` with at most `n` elements in ascending order from that of `from_key`, as `find(from_key)` followed by increments
+    //! On entering a leaf, `prefetch(address, size)` is called for each of the swappable leaves following it in the same parent,
+    //! as many as the rest of the scan would visit if they were minimally filled, so that swapping them in overlaps.
+    //! @return the number of the elements visited, 0 if `from_key` does not exist
+    template <class F, class Prefetch>
+    inline size_t scan(const key_type& from_key, size_t n, F&& f, Prefetch&& prefetch);
+    //! finds each of `keys` into `out` as `find()`, interleaving the lookups (see `interleave_lookups()`)
+    //! Each node to visit is prefetched into the cache, and `prefetch(address, size)` is called for it if it is swappable.
+    template <class Prefetch = NoPrefetch>
+    inline void multi_find(std::span<const key_type> keys, std::span<iterator> out, Prefetch&& prefetch = {});
 
     inline std::pair<iterator, bool> insert(value_type&& x);
     inline size_type erase(const key_type& x);
+    //! replaces the mapped value of `x` if exists
+    //! @return whether `x` exists
+    inline bool update(const key_type& x, const mapped_type& obj);
 
     inline void clear();
 
     inline void batch_block();
     inline void batch_vEB();
+    //! `batch_vEB()` at two levels, for the swap units of the allocator larger than a page, e.g., huge pages.
+    //! The nodes are grouped into subtrees as high as a subtree of full nodes fits in a page of `PageAlign` bytes,
+    //! each of which is laid out as `batch_block()` does, and the subtrees are laid out in the vEB order of the tree of them.
+    template <size_t PageAlign>
+    inline void batch_multilevel_vEB();
+
+    //! Replace the contents with the elements of `sorted`, which must be in strictly ascending order of the keys.
+    //! The nodes are allocated directly in the order that `batch_block()` / `batch_vEB()` would rearrange them into,
+    //! so that no rearrangement is needed afterwards.
+    template <std::ranges::input_range R>
+        requires std::ranges::sized_range<R>
+    inline void bulk_load_block(R&& sorted);
+    template <std::ranges::input_range R>
+        requires std::ranges::sized_range<R>
+    inline void bulk_load_vEB(R&& sorted);
+
+    //! Incremental counterparts of `batch_block()` and `batch_vEB()`.
+    //! Every `period` insertions and erasures, only the subtrees containing the nodes touched by them are rearranged,
+    //! where each subtree is as high as a subtree of full nodes fits in a page of `PageAlign` bytes.
+    //! `period == 0` disables the incremental blocking.
+    template <size_t PageAlign>
+    inline void incremental_block(size_t period);
+    template <size_t PageAlign>
+    inline void incremental_vEB(size_t period);
+
+    //! Access-frequency-driven placement on top of the structural one, i.e., the local prefix of the list.
+    //! Every `sampling_interval`-th lookup counts the visits to the nodes on its path, and every `period` sampled lookups,
+    //! at most `max_swaps` far nodes visited more than the coldest purely-local ones are swapped with them, the hottest first.
+    //! The cold ones are the last node of the local prefix, and the nodes promoted before.
+    //! A node is visited at least as often as its descendants, so no ancestor of a promoted node is demoted for it.
+    //! The counts are halved every round, so that they follow the drift of the hot keys.
+    //! The rounds are run at the beginning of the non-const `find()`, `scan()`, and `multi_find()`, which then invalidate iterators.
+    //! `period == 0` disables it, and demotes the promoted nodes.
+    //! Not available if `Concurrent`, because the lookups relocating nodes are not safe against each other.
+    inline void promote_hot_nodes(size_t period, size_t sampling_interval = 16, size_t max_swaps = 64)
+        requires(!Concurrent);
+
+    //! relocates the element of `x` into the purely local region (only if `OutOfLineValues`)
+    //! The last nodes of the local prefix of the list are evicted to the swappable region as many as needed,
+    //! and the memory left over by them is refilled with the first far nodes.
+    //! The element is unpinned when a split pushes it up to the parent node, which reallocates it in the swappable region.
+    //! @return whether the element of `x` is in the purely local region
+    inline bool pin(const key_type& x)
+        requires OutOfLineValues;
+    //! relocates the element of `x` back to the swappable region, and refills the local prefix with the memory freed
+    //! @return whether the element of `x` has been in the purely local region
+    inline bool unpin(const key_type& x)
+        requires OutOfLineValues;
+    //! the purely local memory used by the index, i.e., the nodes but the elements in them, and by the elements
+    //! An element counts `sizeof(value_type)` wherever it is held, and the rest of the nodes, including their unused slots, counts as the index,
+    //! so that the footprints are comparable between the layouts of `OutOfLineValues`.
+    //! It visits all the nodes, including the swappable ones.
+    //! @return [index_bytes, element_bytes]
+    inline std::array<size_t, 2> local_footprint();
+    //! whether the purely local nodes are the local prefix of the list, up to the last local node, and the promoted nodes
+    //! The insertions keep the nodes split from the local prefix in it only if so.
+    inline bool is_local_prefix_consistent();
 
     //! @return [purely_local_edges, same_page_edges, diff_pages_edges]
     template <size_t PageAlign>
     inline std::array<size_t, 3> analyze_edges();
+    //! simulates the page cache during a traversal in the ascending order of the keys
     //! @return [purely_local, cache_hit, cache_miss]
     template <size_t PageAlign>
-    inline std::array<size_t, 3> analyze_locality_in_traversal(size_t cache_size_in_pages);
+    inline std::array<size_t, 3> analyze_locality_in_traversal(size_t cache_size_in_pages, PageReplacement policy = PageReplacement::FIFO);
+    //! @param cache may be shared with the other analyses, e.g., warmed up by them
+    template <size_t PageAlign>
+    inline std::array<size_t, 3> analyze_locality_in_traversal(PageCacheSimulator& cache);
+    //! calls `visit(address, is_local)` for each node which `find(x)` followed by `n_increments` increments of the iterator visits,
+    //! and each element out of line which they read, in the order of the accesses, e.g., to record a trace (see `AccessTraceWriter`)
+    //! The nodes are only read, and the lookup is not sampled for `promote_hot_nodes()`.
+    template <class Visit>
+    inline void visit_query(const key_type& x, size_t n_increments, Visit&& visit);
 
 private:
     template <class K>
     inline iterator find_impl(const K& x) const;
+    //! a single attempt of the lock-free descent, which calls `read` on the element found (or `end()`)
+    //! @return std::nullopt if a concurrent writer is detected, and then the result of `read` must be discarded
+    template <class K, class F>
+    inline std::optional<std::invoke_result_t<F, const_iterator>> optimistic_find_step(const K& x, F&& read) const;
+
+    //! serializes the writers, and unlatches the nodes at the end of each operation
+    struct WriterScope {
+        BTreeMap& map;
+        inline explicit WriterScope(BTreeMap& map);
+        inline ~WriterScope();
+    };
+    //! must be called before modifying a node readable by `lookup()`, i.e., its `n_elems`, `elems`, or `children`
+    inline void latch(const NodePtr& node);
+    //! destroys a node unlinked from the tree, after the concurrent readers leave it
+    inline void dispose(NodePtr node);
+
+    inline void clear_impl();
 
     struct InsertStepResult {
         std::pair<iterator, bool> result;
         NodePtr new_child = nullptr;
         std::optional<value_type> pushed_up{};
+        // whether the element pushed up has been pinned in the purely local region, and is no longer (only if `OutOfLineValues`)
+        bool local_value_freed = false;
     };
 
     inline InsertStepResult insert_step(value_type&& x, NodePtr node, Suballoc parent_suballoc);
@@ -216,22 +404,71 @@ private:
 
     struct EraseStepResult {
         size_type result;
-        AlignedBuffer<value_type>* pulled_down = nullptr;
+        ElemBuffer* pulled_down = nullptr;
+        // whether the erased element has been pinned in the purely local region (only if `OutOfLineValues`)
+        bool local_value_freed = false;
     };
-    inline EraseStepResult erase_step(const key_type& key, NodePtr node, AlignedBuffer<value_type>* successor);
-    inline AlignedBuffer<value_type>* fill_hole(size_t idx_hole, NodePtr node, AlignedBuffer<value_type>* successor);
-    inline AlignedBuffer<value_type>* swap_predecessor(AlignedBuffer<value_type>&, NodePtr node, AlignedBuffer<value_type>* successor);
-    inline void relocate_first_far_to_local();
-
-    inline void relocate(NodePtr& node, Suballoc suballoc);
+    //! whether the element is pinned in the purely local region (always false unless `OutOfLineValues`)
+    inline bool is_pinned(const ElemBuffer& elem);
+    inline EraseStepResult erase_step(const key_type& key, NodePtr node, ElemBuffer* successor);
+    inline ElemBuffer* fill_hole(size_t idx_hole, NodePtr node, ElemBuffer* successor);
+    inline ElemBuffer* swap_predecessor(ElemBuffer&, NodePtr node, ElemBuffer* successor);
+    //! @return whether a node has been relocated, i.e., the local prefix has not reached the end nor run out of memory
+    inline bool relocate_first_far_to_local();
+
+    //! @return whether `node` has been relocated
+    inline bool relocate(NodePtr& node, Suballoc suballoc);
+    //! relocates a swappable `node` next to the nodes relocated into `block` before, or into a new page if it does not fit
+    inline void relocate_into_block(NodePtr& node, Suballoc& block);
 
     inline void batch_block_step(NodePtr node, Suballoc& swappable_block);
+    //! packs the swappable elements out of line in pages in key order (only if `OutOfLineValues`)
+    inline void pack_values();
+    inline void relocate_value(ElemBuffer& elem, ValueSuballoc suballoc);
     inline void batch_vEB_step(NodePtr& node, size_t height, Suballoc& swappable_block);
+    //! @param page_height the height of the subtrees laid out in a page, to which the levels are sliced from the leaves
+    inline void multilevel_vEB_step(NodePtr node, size_t height, size_t page_height, Suballoc& swappable_block);
+    //! the height of the highest subtree that fits in `page_align` bytes even if all of its nodes are full
+    static constexpr size_t subtree_height_in_page(size_t page_align);
+
+    // The width of a subtree is the number of its elements plus one, i.e., the number of the null children of its leaves.
+    struct BulkLoadState {
+        std::vector<size_t> max_widths;            // the maximum width of a subtree for each height
+        std::vector<std::vector<NodePtr>> levels;  // the nodes for each depth in key order
+        std::vector<size_t> n_visited;             // the number of the nodes visited so far for each depth
+        Suballoc block;
+    };
+    template <class R>
+    inline void bulk_load(R&& sorted, bool is_vEB);
+    //! @return 0 if the node is a leaf
+    inline size_t bulk_load_n_children(size_t width, size_t depth, const BulkLoadState& state) const;
+    inline void bulk_load_place(size_t width, size_t depth, BulkLoadState& state);
+    inline void bulk_load_block_step(size_t width, size_t depth, BulkLoadState& state);
+    inline void bulk_load_vEB_step(size_t width, size_t depth, size_t height, BulkLoadState& state);
+    template <class Iter>
+    inline void bulk_load_fill(NodePtr node, Iter& iter);
+
+    template <size_t PageAlign>
+    inline void enable_incremental_blocking(size_t period, bool is_vEB);
+    inline void touch(NodePtr node);
+    //! @return whether the nodes are rearranged, i.e., iterators are invalidated
+    inline bool count_mutation();
+    inline void reblock_touched_subtrees();
+    inline void reblock_step(NodePtr node, size_t height, Suballoc& swappable_block);
+
+    //! @return whether the lookup about to start counts the visits to the nodes
+    inline bool sample_lookup() const;
+    inline void count_access(const NodePtr& node) const;
+    inline void promote_if_due();
+    inline void promote_hot_nodes_round();
+    inline bool is_promoted(const NodePtr& node) const;
+    //! @return whether `node` has been promoted
+    inline bool unpromote(const NodePtr& node);
 
     template <size_t PageAlign>
     inline void analyze_edges_step(NodePtr node, std::array<size_t, 3>& acc);
     template <size_t PageAlign>
-    inline void analyze_locality_in_traversal_step(NodePtr node, uintptr_t* cached_pages, size_t cache_size, size_t& lr_cache_idx, std::array<size_t, 3>& cnt);
+    inline void analyze_locality_in_traversal_step(NodePtr node, PageCacheSimulator& cache, std::array<size_t, 3>& cnt);
 };
 
 }  // namespace Blocked
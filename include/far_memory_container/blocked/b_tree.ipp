@@ -7,23 +7,36 @@
 #include <cstddef>
 #include <memory>
 #include <optional>
+#include <limits>
+#include <ranges>
 #include <utility>
+#include <vector>
 
 
 namespace FarMemoryContainer::Blocked
 {
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-BTreeMap<Key, T, MaxNElems, Compare, Allocator>::~BTreeMap() noexcept
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::~BTreeMap() noexcept
 {
     clear();
+    if constexpr (Concurrent) {
+        epoch_manager.reclaim_all();
+    }
 
     header->~Node();
     AllocTraits::deallocate(alloc, std::move(header), 1);
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::clear()
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::clear()
+{
+    WriterScope scope{*this};
+    clear_impl();
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::clear_impl()
 {
+    latch(header);
     NodePtr node = header->next;
     while (node != header) {
         NodePtr deleted = std::move(node);
@@ -32,8 +45,7 @@ void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::clear()
         for (size_t i = 0; i != node_ref.n_elems; i++) {
             node_ref.elems[i].destroy(alloc);
         }
-        node_ref.~Node();
-        AllocTraits::deallocate(alloc, std::move(deleted), 1);
+        dispose(std::move(deleted));
     }
     header->n_elems = 1;
     std::ranges::fill(header->children, nullptr);
@@ -43,16 +55,32 @@ void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::clear()
     size_cnt = 0;
     begin_node = header;
     last_local_node = header;
+    n_mutations_since_reblocking = 0;
+    touched_nodes.clear();
+    access_records.clear();
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+size_t BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::height() const noexcept
+{
+    size_t height = 0;
+    for (NodePtr node = header->children[0]; node != nullptr; node = node->children[0]) {
+        height++;
+    }
+    return height;
 }
 
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
 template <class K>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::find_impl(const K& x) const -> iterator
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::find_impl(const K& x) const -> iterator
 {
+    const bool sampled = sample_lookup();
     for (NodePtr node = header->children[0]; node != nullptr;) {
+        if (sampled) {
+            count_access(node);
+        }
         const auto upper_bound = node->upper_bound(x, comp);
-        if (upper_bound == 0 || comp(node->elems[upper_bound - 1].get()->first, x)) {
+        if (upper_bound == 0 || comp(node->key(upper_bound - 1), x)) {
             node = node->children[upper_bound];
         } else {
             return iterator{{.node = node, .elem_idx = upper_bound - 1}};
@@ -60,11 +88,241 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::find_impl(const K& x) cons
     }
     return iterator{{.node = header, .elem_idx = 0}};
 }
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::lower_bound(const_iterator hint, const key_type& x) -> iterator
+{
+    NodePtr node = (hint.node == header ? header->children[0] : hint.node);
+    if (node == nullptr) {
+        return end();
+    }
+    // The subtree of a node whose elements enclose `x` contains the result.
+    while (node->parent != header
+           && (comp(x, node->key(0)) || comp(node->key(node->n_elems - 1), x))) {
+        node = node->parent;
+    }
+
+    iterator res = end();
+    while (node != nullptr) {
+        const auto upper_bound = node->upper_bound(x, comp);
+        if (upper_bound != 0 && !comp(node->key(upper_bound - 1), x)) {
+            return iterator{{.node = std::move(node), .elem_idx = upper_bound - 1}};
+        }
+        if (upper_bound != node->n_elems) {
+            res = iterator{{.node = node, .elem_idx = upper_bound}};
+        }
+        node = node->children[upper_bound];
+    }
+    return res;
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::find(const_iterator hint, const key_type& x) -> iterator
+{
+    const auto iter = lower_bound(std::move(hint), x);
+    return (iter == end() || comp(x, iter->first)) ? end() : iter;
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+template <class K, class F>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::optimistic_find_step(const K& x, F&& read) const -> std::optional<std::invoke_result_t<F, const_iterator>>
+{
+    using Result = std::invoke_result_t<F, const_iterator>;
+
+    NodePtr node = header;
+    auto version = node->version.read_begin();
+    if (!version) {
+        return std::nullopt;
+    }
+    for (size_t child_idx = 0;;) {
+        // The pointer to the child is valid only if the parent has not been modified since its snapshot,
+        // and so is the snapshot of the child.
+        NodePtr child = node->children[child_idx];
+        if (!node->version.read_validate(*version)) {
+            return std::nullopt;
+        }
+        if (/* not found */ child == nullptr) {
+            return std::optional<Result>{std::in_place, read(end())};
+        }
+        const auto child_version = child->version.read_begin();
+        if (!child_version || !node->version.read_validate(*version)) {
+            return std::nullopt;
+        }
+        node = std::move(child);
+        version = child_version;
+
+        const size_t n_elems = node->n_elems;
+        if (/* torn read */ n_elems == 0 || n_elems > MaxNElems) {
+            return std::nullopt;
+        }
+        const auto upper_bound = node->upper_bound(x, comp, n_elems);
+        if (upper_bound == 0 || comp(node->key(upper_bound - 1), x)) {
+            child_idx = upper_bound;
+        } else {
+            std::optional<Result> res{std::in_place, read(const_iterator{{.node = node, .elem_idx = upper_bound - 1}})};
+            if (!node->version.read_validate(*version)) {
+                return std::nullopt;
+            }
+            return res;
+        }
+    }
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::lookup(const key_type& x) const -> std::optional<mapped_type>
+{
+    const auto read = [this](const_iterator iter) -> std::optional<mapped_type> {
+        if (iter == end()) {
+            return std::nullopt;
+        }
+        return iter->second;
+    };
+
+    if constexpr (Concurrent) {
+        for (;;) {
+            // re-pinned on every restart so that a writer waiting for a grace period is not blocked
+            [[maybe_unused]] const auto guard = epoch_manager.pin();
+            if (auto res = optimistic_find_step(x, read)) {
+                return *std::move(res);
+            }
+        }
+    } else {
+        return read(find_impl(x));
+    }
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+template <class F, class Prefetch>
+size_t BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::scan(const key_type& from_key, const size_t n, F&& f, Prefetch&& prefetch)
+{
+    promote_if_due();
+    auto local = AllocTraits::get_suballocator(alloc, purely_local);
+    NodePtr prefetched_parent = nullptr;
+
+    size_t cnt = 0;
+    for (auto iter = find_impl(from_key); cnt != n && iter != end(); cnt++, ++iter) {
+        if (/* leaf but not the root */ iter.node->children[0] == nullptr && iter.node->parent != prefetched_parent && iter.node->parent != header) {
+            prefetched_parent = iter.node->parent;
+            const auto& siblings = prefetched_parent->children;
+            // the elements left after this leaf, where each following leaf is preceded by an element of the parent
+            size_t rest = n - cnt - std::min(n - cnt, iter.node->n_elems - iter.elem_idx);
+            for (auto sibling = std::ranges::find(siblings, iter.node) + 1;
+                 rest > 1 && sibling != siblings.begin() + prefetched_parent->n_elems + 1; sibling++) {
+                rest -= std::min(rest, MinNElems + 1);
+                if (const NodePtr& leaf = *sibling; !AllocTraits::if_suballocator_contains(alloc, local, leaf)) {
+                    prefetch(static_cast<const void*>(&(*leaf)), sizeof(Node));
+                }
+            }
+        }
+        f(*iter);
+    }
+    return cnt;
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+template <class Prefetch>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::multi_find(std::span<const key_type> keys, std::span<iterator> out, Prefetch&& prefetch)
+{
+    promote_if_due();
+    auto local = AllocTraits::get_suballocator(alloc, purely_local);
+    const auto hint = [&](const NodePtr& node) {
+        __builtin_prefetch(&(*node));
+        if (!AllocTraits::if_suballocator_contains(alloc, local, node)) {
+            prefetch(static_cast<const void*>(&(*node)), sizeof(Node));
+        }
+    };
+
+    // a lookup of `keys[idx]` about to visit `node`
+    struct State {
+        size_t idx;
+        NodePtr node;
+        bool sampled;
+    };
+    interleave_lookups<State>(
+        keys.size(),
+        [&](State& state, const size_t idx) {
+            state = {.idx = idx, .node = header->children[0], .sampled = sample_lookup()};
+            if (state.node == nullptr) {
+                out[idx] = end();
+                return false;
+            }
+            hint(state.node);
+            return true;
+        },
+        [&](State& state) {
+            const auto& x = keys[state.idx];
+            if (state.sampled) {
+                count_access(state.node);
+            }
+            const auto upper_bound = state.node->upper_bound(x, comp);
+            if (upper_bound != 0 && !comp(state.node->key(upper_bound - 1), x)) {
+                out[state.idx] = iterator{{.node = std::move(state.node), .elem_idx = upper_bound - 1}};
+                return false;
+            }
+            state.node = state.node->children[upper_bound];
+            if (state.node == nullptr) {
+                out[state.idx] = end();
+                return false;
+            }
+            hint(state.node);
+            return true;
+        });
+}
 
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert(value_type&& x) -> std::pair<iterator, bool>
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::WriterScope::WriterScope(BTreeMap& map) : map(map)
+{
+    if constexpr (Concurrent) {
+        map.writer_mutex.lock();
+    }
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::WriterScope::~WriterScope()
 {
+    if constexpr (Concurrent) {
+        for (auto& node : map.latched_nodes) {
+            node->version.unlatch();
+        }
+        map.latched_nodes.clear();
+        map.epoch_manager.collect();
+        map.writer_mutex.unlock();
+    }
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::latch(const NodePtr& node)
+{
+    if constexpr (Concurrent) {
+        if (!node->version.is_latched()) {
+            node->version.latch();
+            latched_nodes.push_back(node);
+        }
+    }
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::dispose(NodePtr node)
+{
+    if constexpr (Concurrent) {
+        // left latched, i.e., obsolete for the readers that have reached it
+        latch(node);
+        std::erase(latched_nodes, node);
+        const bool is_local = AllocTraits::if_suballocator_contains(alloc, AllocTraits::get_suballocator(alloc, purely_local), node);
+        epoch_manager.retire([this, node]() mutable {
+            node->~Node();
+            AllocTraits::deallocate(alloc, std::move(node), 1);
+        });
+        if (is_local) {
+            // The local memory is made available at once, because the placement assumes that the freed node can be reused right after.
+            epoch_manager.synchronize();
+        }
+    } else {
+        if (!access_records.empty()) {
+            access_records.erase(&(*node));
+        }
+        node->~Node();
+        AllocTraits::deallocate(alloc, std::move(node), 1);
+    }
+}
+
+
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::insert(value_type&& x) -> std::pair<iterator, bool>
+{
+    WriterScope scope{*this};
     auto suballoc = AllocTraits::get_suballocator(alloc, header);
     NodePtr root = header->children[0];
     if (/* first element */ root == nullptr) {
@@ -80,7 +338,9 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert(value_type&& x) ->
         auto& [root] = *allocated;
         new (&(*root)) Node{.n_elems = 1, .children = {}, .parent = header, .prev = header, .next = header};
         root->elems[0].construct(alloc, std::move(x));
+        root->refresh_keys();
 
+        latch(header);
         header->children[0] = header->prev = header->next = begin_node = root;
         if (is_local) {
             last_local_node = root;
@@ -104,6 +364,7 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert(value_type&& x) ->
                 if (new_child_relocated) {
                     res.new_child = last_local_node->next;
                 }
+                root = header->children[0];  // the root itself may have been relocated
             } else {
                 suballoc = AllocTraits::get_suballocator(alloc, swappable_plain);
             }
@@ -118,27 +379,46 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert(value_type&& x) ->
         }
 
         new (&(*new_node)) Node{.n_elems = 1, .children = {root, res.new_child}, .parent = header, .prev = header, .next = root};
+        latch(header);
         header->next = root->prev = header->children[0] = root->parent = res.new_child->parent = new_node;
         new_node->elems[0].construct(alloc, std::move(*res.pushed_up));
+        new_node->refresh_keys();
+        touch(new_node);
 
         if (res.result.first.node == nullptr) {
             res.result.first = {{.node = new_node, .elem_idx = 0}};
         }
     }
 
+    if (res.local_value_freed) {
+        // The local prefix takes the memory of the pinned element pushed up, which has been reallocated in the swappable region.
+        const key_type key = res.result.first->first;
+        while (last_local_node != header->prev && relocate_first_far_to_local()) {
+        }
+        res.result.first = find_impl(key);
+    }
+
+    if (res.result.second && reblocking_period != 0) {
+        const key_type key = res.result.first->first;
+        if (count_mutation()) {
+            res.result.first = find_impl(key);
+        }
+    }
     return res.result;
 }
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert_step(value_type&& x, NodePtr node, Suballoc suballoc) -> InsertStepResult
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::insert_step(value_type&& x, NodePtr node, Suballoc suballoc) -> InsertStepResult
 {
     const auto upper_bound = node->upper_bound(x.first, comp);
-    if (/* already exists */ upper_bound != 0 && !comp(node->elems[upper_bound - 1].get()->first, x.first)) {
+    if (/* already exists */ upper_bound != 0 && !comp(node->key(upper_bound - 1), x.first)) {
         return {.result = {{{.node = std::move(node), .elem_idx = upper_bound - 1}}, false}};
     }
 
     auto node_suballoc = AllocTraits::get_suballocator(alloc, node);
-    const bool must_alloc_locally = (AllocTraits::if_suballocator_contains(alloc, node_suballoc, header) && node != last_local_node);
+    // The promoted nodes are out of the local prefix, and so are their new siblings.
+    const bool in_local_prefix = (AllocTraits::if_suballocator_contains(alloc, node_suballoc, header) && !is_promoted(node)),
+               must_alloc_locally = (in_local_prefix && node != last_local_node);
 
     bool to_insert;
     InsertStepResult res = (/* leaf node */ node->children[upper_bound] == nullptr
@@ -153,6 +433,7 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert_step(value_type&& x
     if (!to_insert) {
         return res;
     }
+    latch(node);
     auto&& inserted = std::move(node->children[upper_bound] == nullptr ? x : *res.pushed_up);
 
     if (/* not full */ node->n_elems != MaxNElems) {
@@ -164,6 +445,7 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert_step(value_type&& x
         node->children[upper_bound + 1] = std::move(res.new_child);
         res.new_child = nullptr;
         node->n_elems++;
+        node->refresh_keys();
 
         if (res.result.first.node == nullptr) {
             res.result.first = {{.node = node, .elem_idx = upper_bound}};
@@ -172,6 +454,10 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert_step(value_type&& x
         return res;
     }
 
+    if (!in_local_prefix && AllocTraits::if_suballocator_contains(alloc, suballoc, header)) {
+        // The new sibling would be out of the local prefix, even if the purely local region had room for it.
+        suballoc = AllocTraits::get_suballocator(alloc, swappable_plain);
+    }
     auto allocated = SuballocTraits::batch_allocate(suballoc, request::single<Node>());
     if (!allocated) {
         if (must_alloc_locally) {
@@ -221,6 +507,7 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert_step(value_type&& x
         }
         new_node->children[0] = std::move(node->children[node->n_elems]);
         value_type pushed_up = std::move(*node->elems[node->n_elems - 1].get());
+        res.local_value_freed = res.local_value_freed || is_pinned(node->elems[node->n_elems - 1]);
         node->elems[node->n_elems - 1].destroy(alloc);
         for (size_t i = node->n_elems - 1; i != upper_bound; i--) {
             node->elems[i].move_from(alloc, node->elems[i - 1]);
@@ -248,9 +535,10 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert_step(value_type&& x
             node->children[i] = nullptr;
         }
         if (res.result.first.node == nullptr) {
-            res.result.first = {{.node = new_node, .elem_idx = upper_bound - node->n_elems}};
+            res.result.first = {{.node = new_node, .elem_idx = upper_bound - node->n_elems - 1}};
         }
         res.pushed_up.emplace(std::move(*node->elems[node->n_elems].get()));
+        res.local_value_freed = res.local_value_freed || is_pinned(node->elems[node->n_elems]);
         node->elems[node->n_elems].destroy(alloc);
     }
 
@@ -260,62 +548,108 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert_step(value_type&& x
         }
     }
 
+    node->refresh_keys();
+    new_node->refresh_keys();
+    touch(new_node);
     res.new_child = new_node;
     return res;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::relocate_last_local_to_far()
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+bool BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::update(const key_type& x, const mapped_type& obj)
+{
+    WriterScope scope{*this};
+    auto iter = find_impl(x);
+    if (iter == end()) {
+        return false;
+    }
+    latch(iter.node);
+    iter->second = obj;
+    return true;
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::relocate_last_local_to_far()
 {
     NodePtr node = std::move(last_local_node);
     last_local_node = node->prev;
     relocate(node, AllocTraits::get_suballocator(alloc, swappable_plain));
+    touch(node);
 }
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::erase(const key_type& key) -> size_type
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::erase(const key_type& key) -> size_type
 {
+    WriterScope scope{*this};
     NodePtr root = header->children[0];
     if (root == nullptr) {
         return 0;
     }
-    const auto result = erase_step(key, header->children[0], &header->elems[0]).result;
+    const auto erased = erase_step(key, header->children[0], &header->elems[0]);
+    const auto result = erased.result;
 
     if (root->n_elems == 0) {
         auto local_suballoc = AllocTraits::get_suballocator(alloc, purely_local);
         const bool to_relocate = (AllocTraits::if_suballocator_contains(alloc, local_suballoc, root) && last_local_node != header->prev);
 
+        latch(header);
         header->children[0] = std::move(root->children[0]);
         root->next->prev = header;
         header->next = std::move(root->next);
         if (header->children[0] != nullptr) {
             header->children[0]->parent = header;
+        } else {
+            // the last element has been erased
+            begin_node = header;
         }
         if (last_local_node == root) {
             last_local_node = header;
         }
 
-        root->~Node();
-        AllocTraits::deallocate(alloc, std::move(root), 1);
+        dispose(std::move(root));
         if (to_relocate) {
-            relocate_first_far_to_local();
+            n_pending_local_refills++;
+        }
+    }
+    for (; n_pending_local_refills != 0; n_pending_local_refills--) {
+        relocate_first_far_to_local();
+    }
+    if (erased.local_value_freed) {
+        // The local prefix takes the memory of the pinned element, so that the nodes split later do not go out of it.
+        while (last_local_node != header->prev && relocate_first_far_to_local()) {
         }
     }
 
+    if (result != 0) {
+        count_mutation();
+    }
     return result;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::erase_step(const key_type& key, NodePtr node, AlignedBuffer<value_type>* successor) -> EraseStepResult
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+bool BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::is_pinned(const ElemBuffer& elem)
+{
+    if constexpr (OutOfLineValues) {
+        allocator_type value_alloc{alloc};
+        return ValueAllocTraits::if_suballocator_contains(value_alloc, ValueAllocTraits::get_suballocator(value_alloc, purely_local), elem.ptr);
+    } else {
+        return false;
+    }
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::erase_step(const key_type& key, NodePtr node, ElemBuffer* successor) -> EraseStepResult
 {
     const auto upper_bound = node->upper_bound(key, comp);
-    if (/* already exists */ upper_bound != 0 && !comp(node->elems[upper_bound - 1].get()->first, key)) {
+    if (/* already exists */ upper_bound != 0 && !comp(node->key(upper_bound - 1), key)) {
+        latch(node);
+        const bool local_value_freed = is_pinned(node->elems[upper_bound - 1]);
         node->elems[upper_bound - 1].destroy(alloc);
         size_cnt--;
 
         if (/* leaf node */ node->children[upper_bound - 1] == nullptr) {
-            return {.result = 1, .pulled_down = fill_hole(upper_bound - 1, node, successor)};
+            return {.result = 1, .pulled_down = fill_hole(upper_bound - 1, node, successor), .local_value_freed = local_value_freed};
         }
         const auto* pulled_down = swap_predecessor(node->elems[upper_bound - 1], node->children[upper_bound - 1], &node->elems[upper_bound - 1]);
-        return {.result = 1, .pulled_down = (pulled_down == nullptr ? nullptr : fill_hole(pulled_down - &node->elems[0], node, successor))};
+        // the predecessor has been moved to this node
+        node->refresh_keys();
+        return {.result = 1, .pulled_down = (pulled_down == nullptr ? nullptr : fill_hole(pulled_down - &node->elems[0], node, successor)), .local_value_freed = local_value_freed};
     }
 
     if (/* leaf node */ node->children[upper_bound] == nullptr) {
@@ -327,19 +661,21 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::erase_step(const key_type&
     }
     return res;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::swap_predecessor(AlignedBuffer<value_type>& target, NodePtr node, AlignedBuffer<value_type>* successor) -> AlignedBuffer<value_type>*
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::swap_predecessor(ElemBuffer& target, NodePtr node, ElemBuffer* successor) -> ElemBuffer*
 {
     if (/* leaf node */ node->children[node->n_elems] == nullptr) {
+        latch(node);
         target.move_from(alloc, node->elems[node->n_elems - 1]);
         return fill_hole(node->n_elems - 1, node, successor);
     }
     const auto* pulled_down = swap_predecessor(target, node->children[node->n_elems], &node->elems[node->n_elems]);
     return (pulled_down == nullptr ? nullptr : fill_hole(pulled_down - &node->elems[0], node, successor));
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::fill_hole(const size_t idx_hole, NodePtr node, AlignedBuffer<value_type>* successor) -> AlignedBuffer<value_type>*
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::fill_hole(const size_t idx_hole, NodePtr node, ElemBuffer* successor) -> ElemBuffer*
 {
+    latch(node);
     for (size_t i = idx_hole + 1; i != node->n_elems; i++) {
         node->elems[i - 1].move_from(alloc, node->elems[i]);
         node->children[i] = std::move(node->children[i + 1]);
@@ -348,11 +684,16 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::fill_hole(const size_t idx
 
     if (/* not minimal */ node->n_elems != MinNElems || /* root */ node == header->children[0]) {
         node->n_elems--;
+        node->refresh_keys();
         return nullptr;
     }
 
+    // `successor` is in the parent
+    latch(node->parent);
+
     NodePtr prev = node->prev;
     if (prev->parent == node->parent && prev->n_elems != MinNElems) {
+        latch(prev);
         for (size_t i = MinNElems - 1; i != 0; i--) {
             node->elems[i].move_from(alloc, node->elems[i - 1]);
             node->children[i + 1] = std::move(node->children[i]);
@@ -366,11 +707,15 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::fill_hole(const size_t idx
         }
         prev->children[prev->n_elems] = nullptr;
         prev->n_elems--;
+        node->refresh_keys();
+        prev->refresh_keys();
+        node->parent->refresh_keys();
         return nullptr;
     }
 
     NodePtr next = node->next;
     if (next->parent == node->parent && next->n_elems != MinNElems) {
+        latch(next);
         node->elems[MinNElems - 1].move_from(alloc, *successor);
         node->children[MinNElems] = std::move(next->children[0]);
         if (/* inner node */ node->children[MinNElems] != nullptr) {
@@ -384,6 +729,9 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::fill_hole(const size_t idx
         }
         next->children[next->n_elems] = nullptr;
         next->n_elems--;
+        node->refresh_keys();
+        next->refresh_keys();
+        node->parent->refresh_keys();
         return nullptr;
     }
 
@@ -393,6 +741,7 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::fill_hole(const size_t idx
         node = std::move(prev);
         successor--;
     }
+    latch(node);
 
     auto local_suballoc = AllocTraits::get_suballocator(alloc, purely_local);
     const bool to_relocate = (AllocTraits::if_suballocator_contains(alloc, local_suballoc, next) && last_local_node != header->prev);
@@ -413,37 +762,76 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::fill_hole(const size_t idx
     node->n_elems = 2 * MinNElems;
     next->next->prev = node;
     node->next = next->next;
+    // the parent is refreshed by the caller after filling the hole of `successor`
+    node->refresh_keys();
+    touch(node);
 
-    next->~Node();
-    AllocTraits::deallocate(alloc, std::move(next), 1);
+    dispose(std::move(next));
     if (to_relocate) {
-        relocate_first_far_to_local();
+        // The parent still holds `next`, and `successor` is in it.
+        n_pending_local_refills++;
     }
     return successor;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::relocate_first_far_to_local()
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+bool BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::relocate_first_far_to_local()
 {
     NodePtr node = last_local_node->next;
-    relocate(node, AllocTraits::get_suballocator(alloc, purely_local));
+    // the promoted nodes just after the local prefix join it as they are
+    while (unpromote(node)) {
+        last_local_node = node;
+        node = node->next;
+    }
+    if (node == header) {
+        return false;
+    }
+    auto local = AllocTraits::get_suballocator(alloc, purely_local);
+    relocate(node, local);
+    if (!AllocTraits::if_suballocator_contains(alloc, local, node)) {
+        return false;
+    }
     last_local_node = node;
+    return true;
 }
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::relocate(NodePtr& node, Suballoc suballoc)
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+bool BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::relocate(NodePtr& node, Suballoc suballoc)
 {
     const bool relocating_begin_node = (node == begin_node);
+    const Node* const address = &(*node);
     const auto child_iter_to_node = std::ranges::find(node->parent->children, node);
 
-    if (AllocTraits::relocate(
-            alloc, suballoc, [this](Node* from, auto, Node* to) {
-                new (to) Node{.n_elems = from->n_elems, .children = from->children, .parent = from->parent, .prev = from->prev, .next = from->next};
-                for (size_t i = 0; i != to->n_elems; i++) {
-                    to->elems[i].move_from(alloc, from->elems[i]);
-                }
-                from->~Node();
-            },
-            std::tie(node), request::single<Node>())) {
+    const auto move_node = [this](Node* from, Node* to) {
+        new (to) Node{.n_elems = from->n_elems, .children = from->children, .parent = from->parent, .prev = from->prev, .next = from->next};
+        for (size_t i = 0; i != to->n_elems; i++) {
+            to->elems[i].move_from(alloc, from->elems[i]);
+        }
+        to->keys = from->keys;
+    };
+
+    const bool relocated = [&] {
+        if constexpr (Concurrent) {
+            // The original node is left to the readers that have reached it, and reclaimed after they leave.
+            auto allocated = SuballocTraits::batch_allocate(suballoc, request::single<Node>());
+            if (!allocated) {
+                return false;
+            }
+            latch(node);
+            latch(node->parent);
+            NodePtr from = std::exchange(node, std::move(std::get<0>(*allocated)));
+            move_node(&(*from), &(*node));
+            dispose(std::move(from));
+            return true;
+        } else {
+            return AllocTraits::relocate(
+                alloc, suballoc, [&move_node](Node* from, auto, Node* to) {
+                    move_node(from, to);
+                    from->~Node();
+                },
+                std::tie(node), request::single<Node>());
+        }
+    }();
+    if (relocated) {
 
         if (child_iter_to_node != node->parent->children.end()) {
             *child_iter_to_node = node;
@@ -457,21 +845,36 @@ void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::relocate(NodePtr& node, Su
         if (relocating_begin_node) {
             begin_node = node;
         }
+        if (!access_records.empty()) {
+            if (auto record = access_records.extract(address)) {
+                record.key() = &(*node);
+                record.mapped().node = node;
+                access_records.insert(std::move(record));
+            }
+        }
     }
+    return relocated;
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::relocate_into_block(NodePtr& node, Suballoc& block)
+{
+    PageAwarePlacement::relocate_by<AllocTraits>(alloc, block, [&](Suballoc& suballoc) { return relocate(node, suballoc); });
 }
 
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::batch_block()
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::batch_block()
 {
+    WriterScope scope{*this};
+    pack_values();
     if (header->prev == last_local_node) {
         return;
     }
     auto block = AllocTraits::get_suballocator(alloc, new_per_page);
     batch_block_step(header->children[0], block);
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::batch_block_step(NodePtr node, Suballoc& block)
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::batch_block_step(NodePtr node, Suballoc& block)
 {
     if (/* inner node */ node->children[0] != nullptr) {
         for (size_t i = 0; i <= node->n_elems; i++) {
@@ -481,16 +884,48 @@ void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::batch_block_step(NodePtr n
 
     if (auto local = AllocTraits::get_suballocator(alloc, purely_local);
         !AllocTraits::if_suballocator_contains(alloc, local, node)) {
-        if (!SuballocTraits::is_occupancy_under(block, 0.7)) {
-            block = AllocTraits::get_suballocator(alloc, new_per_page);
+        relocate_into_block(node, block);
+    }
+}
+
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::pack_values()
+{
+    if constexpr (OutOfLineValues) {
+        allocator_type value_alloc{alloc};
+        auto local = ValueAllocTraits::get_suballocator(value_alloc, purely_local);
+        auto block = ValueAllocTraits::get_suballocator(value_alloc, new_per_page);
+        // in key order, so that a range scan touches the pages in sequence
+        for (auto iter = begin(); iter != end(); ++iter) {
+            auto& elem = iter.node->elems[iter.elem_idx];
+            if (!ValueAllocTraits::if_suballocator_contains(value_alloc, local, elem.ptr)) {
+                PageAwarePlacement::relocate<ValueAllocTraits>(
+                    value_alloc, block, [](value_type* from, auto, value_type* to) {
+                        new (to) value_type{std::move(*from)};
+                        from->~value_type();
+                    },
+                    std::tie(elem.ptr), SingleObject<value_type>{});
+            }
         }
-        relocate(node, block);
     }
 }
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::relocate_value(ElemBuffer& elem, ValueSuballoc suballoc)
+{
+    allocator_type value_alloc{alloc};
+    ValueAllocTraits::relocate(
+        value_alloc, suballoc, [](value_type* from, auto, value_type* to) {
+            new (to) value_type{std::move(*from)};
+            from->~value_type();
+        },
+        std::tie(elem.ptr), request::single<value_type>());
+}
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::batch_vEB()
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::batch_vEB()
 {
+    WriterScope scope{*this};
+    pack_values();
     if (header->prev == last_local_node) {
         return;
     }
@@ -503,8 +938,8 @@ void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::batch_vEB()
     auto block = AllocTraits::get_suballocator(alloc, new_per_page);
     batch_vEB_step(root, height, block);
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::batch_vEB_step(NodePtr& node, size_t height, Suballoc& block)
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::batch_vEB_step(NodePtr& node, size_t height, Suballoc& block)
 {
     switch (height) {
     case 0:
@@ -512,10 +947,7 @@ void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::batch_vEB_step(NodePtr& no
     case 1: {
         if (auto local = AllocTraits::get_suballocator(alloc, purely_local);
             !AllocTraits::if_suballocator_contains(alloc, local, node)) {
-            if (!SuballocTraits::is_occupancy_under(block, 0.7)) {
-                block = AllocTraits::get_suballocator(alloc, new_per_page);
-            }
-            relocate(node, block);
+            relocate_into_block(node, block);
         }
     } break;
 
@@ -537,9 +969,590 @@ void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::batch_vEB_step(NodePtr& no
     }
 }
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+template <size_t PageAlign>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::batch_multilevel_vEB()
+{
+    WriterScope scope{*this};
+    pack_values();
+    if (header->prev == last_local_node) {
+        return;
+    }
+
+    auto root = header->children[0];
+    size_t height = 0;
+    for (auto node = root; node != nullptr; node = node->children[0]) {
+        height++;
+    }
+    auto block = AllocTraits::get_suballocator(alloc, new_per_page);
+    multilevel_vEB_step(root, height, subtree_height_in_page(PageAlign), block);
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::multilevel_vEB_step(NodePtr node, size_t height, size_t page_height, Suballoc& block)
+{
+    if (height <= page_height) {
+        reblock_step(node, height, block);
+        return;
+    }
+
+    // The slices of `page_height` levels are split in half as `batch_vEB_step()` splits the levels,
+    // so that the upper subtree ends at the boundary of a slice, and the lower subtrees consist of whole slices.
+    const auto n_slices = (height + page_height - 1) / page_height;
+    const auto lower_height = n_slices / 2 * page_height, upper_height = height - lower_height;
+
+    // The lower subtrees stay where they are while the upper one is relocated.
+    auto lower_first = node, lower_last = lower_first;
+    for (auto down_cnt = upper_height; down_cnt != 0; down_cnt--) {
+        lower_first = lower_first->children[0];
+        lower_last = lower_last->children[lower_last->n_elems];
+    }
+    multilevel_vEB_step(node, upper_height, page_height, block);
+
+    for (auto subtree = lower_first;;) {
+        // taken before `subtree` is relocated
+        const auto next = subtree->next;
+        const bool is_last = (subtree == lower_last);
+        multilevel_vEB_step(subtree, lower_height, page_height, block);
+        if (is_last) {
+            break;
+        }
+        subtree = next;
+    }
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+constexpr size_t BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::subtree_height_in_page(size_t page_align)
+{
+    size_t height = 1;
+    for (size_t n_nodes = MaxNElems + 2; n_nodes * sizeof(Node) <= page_align; n_nodes = n_nodes * (MaxNElems + 1) + 1) {
+        height++;
+    }
+    return height;
+}
+
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
 template <size_t PageAlign>
-std::array<size_t, 3> BTreeMap<Key, T, MaxNElems, Compare, Allocator>::analyze_edges()
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::incremental_block(size_t period)
+{
+    WriterScope scope{*this};
+    enable_incremental_blocking<PageAlign>(period, false);
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+template <size_t PageAlign>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::incremental_vEB(size_t period)
+{
+    WriterScope scope{*this};
+    enable_incremental_blocking<PageAlign>(period, true);
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+template <size_t PageAlign>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::enable_incremental_blocking(size_t period, bool is_vEB)
+{
+    reblocking_period = period;
+    reblocking_height = subtree_height_in_page(PageAlign);
+    reblocking_vEB = is_vEB;
+    n_mutations_since_reblocking = 0;
+    touched_nodes.clear();
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::touch(NodePtr node)
+{
+    if (reblocking_period == 0) {
+        return;
+    }
+
+    // the height is counted from the leaves, so that it is kept even if the root is split
+    size_t height = 1;
+    for (NodePtr descendant = node->children[0]; descendant != nullptr; descendant = descendant->children[0]) {
+        height++;
+    }
+    touched_nodes.emplace_back(node->key(0), height);
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+bool BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::count_mutation()
+{
+    if (reblocking_period == 0 || ++n_mutations_since_reblocking != reblocking_period) {
+        return false;
+    }
+    n_mutations_since_reblocking = 0;
+    if (touched_nodes.empty()) {
+        return false;
+    }
+
+    reblock_touched_subtrees();
+    return true;
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::reblock_touched_subtrees()
+{
+    NodePtr root = header->children[0];
+    size_t tree_height = 0;
+    for (auto node = root; node != nullptr; node = node->children[0]) {
+        tree_height++;
+    }
+
+    // The tree is sliced every `reblocking_height` levels from the leaves,
+    // and each touched node is rearranged together with the other nodes in the same slice of the same subtree.
+    // Sorting by slice and then by key makes the duplicated subtrees adjacent.
+    std::ranges::sort(touched_nodes, [this](const auto& lhs, const auto& rhs) {
+        const auto lhs_slice = (lhs.second - 1) / reblocking_height, rhs_slice = (rhs.second - 1) / reblocking_height;
+        return lhs_slice != rhs_slice ? lhs_slice < rhs_slice : comp(lhs.first, rhs.first);
+    });
+    std::vector<std::pair<NodePtr, size_t>> subtrees;  // (root of a subtree, height of the subtree)
+    subtrees.reserve(touched_nodes.size());
+    for (const auto& [key, height] : touched_nodes) {
+        if (/* the level has been removed by erasure */ height > tree_height) {
+            continue;
+        }
+        const auto lowest = (height - 1) / reblocking_height * reblocking_height + 1,
+                   highest = std::min(lowest + reblocking_height - 1, tree_height);
+
+        NodePtr node = root;
+        for (auto down_cnt = tree_height - highest; down_cnt != 0; down_cnt--) {
+            node = node->children[node->upper_bound(key, comp)];
+        }
+        subtrees.emplace_back(node, highest - lowest + 1);
+    }
+    touched_nodes.clear();
+    subtrees.erase(std::ranges::unique(subtrees).begin(), subtrees.end());
+
+    // Relocating the nodes in a slice doesn't move the roots of the subtrees in the other slices.
+    auto block = AllocTraits::get_suballocator(alloc, new_per_page);
+    for (auto& [subtree, height] : subtrees) {
+        if (reblocking_vEB) {
+            batch_vEB_step(subtree, height, block);
+        } else {
+            reblock_step(subtree, height, block);
+        }
+    }
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::reblock_step(NodePtr node, size_t height, Suballoc& block)
+{
+    if (height != 1 && /* inner node */ node->children[0] != nullptr) {
+        for (size_t i = 0; i <= node->n_elems; i++) {
+            reblock_step(node->children[i], height - 1, block);
+        }
+    }
+
+    if (auto local = AllocTraits::get_suballocator(alloc, purely_local);
+        !AllocTraits::if_suballocator_contains(alloc, local, node)) {
+        relocate_into_block(node, block);
+    }
+}
+
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::promote_hot_nodes(size_t period, size_t sampling_interval, size_t max_swaps)
+    requires(!Concurrent)
+{
+    if (period == 0) {
+        std::vector<NodePtr> promoted;
+        for (const auto& [address, record] : access_records) {
+            if (record.promoted) {
+                promoted.push_back(record.node);
+            }
+        }
+        for (auto& node : promoted) {
+            // It may have joined the local prefix after the demotion of the previous one.
+            if (unpromote(node)) {
+                relocate(node, AllocTraits::get_suballocator(alloc, swappable_plain));
+                relocate_first_far_to_local();
+            }
+        }
+        access_records.clear();
+    }
+
+    promotion_period = period;
+    promotion_sampling_interval = std::max<size_t>(sampling_interval, 1);
+    promotion_max_swaps = max_swaps;
+    n_lookups_since_sampling = 0;
+    n_sampled_lookups = 0;
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+bool BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::sample_lookup() const
+{
+    if (promotion_period == 0 || ++n_lookups_since_sampling != promotion_sampling_interval) {
+        return false;
+    }
+    n_lookups_since_sampling = 0;
+    n_sampled_lookups++;
+    return true;
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::count_access(const NodePtr& node) const
+{
+    access_records.try_emplace(&(*node), AccessRecord{.node = node, .cnt = 0, .promoted = false}).first->second.cnt++;
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::promote_if_due()
+{
+    if (promotion_period != 0 && n_sampled_lookups >= promotion_period) {
+        n_sampled_lookups = 0;
+        promote_hot_nodes_round();
+    }
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::promote_hot_nodes_round()
+{
+    auto local = AllocTraits::get_suballocator(alloc, purely_local);
+
+    // (count, node) of the far nodes, the hottest first, and of the promoted nodes, the coldest last
+    std::vector<std::pair<size_t, NodePtr>> hot, cold;
+    for (const auto& [address, record] : access_records) {
+        if (record.promoted) {
+            cold.emplace_back(record.cnt, record.node);
+        } else if (!AllocTraits::if_suballocator_contains(alloc, local, record.node)) {
+            hot.emplace_back(record.cnt, record.node);
+        }
+    }
+    const auto hotter = [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; };
+    const auto n_candidates = std::min(hot.size(), promotion_max_swaps);
+    std::ranges::partial_sort(hot, hot.begin() + n_candidates, hotter);
+    hot.resize(n_candidates);
+    std::ranges::sort(cold, hotter);
+
+    for (auto& [cnt, node] : hot) {
+        const auto last_local_cnt = [&] {
+            if (last_local_node == header) {
+                return std::numeric_limits<size_t>::max();
+            }
+            const auto iter = access_records.find(&(*last_local_node));
+            return iter == access_records.end() ? size_t{0} : iter->second.cnt;
+        }();
+        const bool demoting_last_local = (cold.empty() || last_local_cnt <= cold.back().first);
+        if (cnt <= (demoting_last_local ? last_local_cnt : cold.back().first)) {
+            break;
+        }
+
+        if (demoting_last_local) {
+            relocate_last_local_to_far();
+        } else {
+            unpromote(cold.back().second);
+            relocate(cold.back().second, AllocTraits::get_suballocator(alloc, swappable_plain));
+            cold.pop_back();
+        }
+        relocate(node, local);
+        if (!AllocTraits::if_suballocator_contains(alloc, local, node)) {
+            relocate_first_far_to_local();
+            break;
+        }
+        access_records.at(&(*node)).promoted = true;
+    }
+
+    for (auto iter = access_records.begin(); iter != access_records.end();) {
+        auto& record = iter->second;
+        record.cnt /= 2;
+        iter = (record.cnt == 0 && !record.promoted ? access_records.erase(iter) : std::next(iter));
+    }
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+bool BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::is_promoted(const NodePtr& node) const
+{
+    if (access_records.empty()) {
+        return false;
+    }
+    const auto iter = access_records.find(&(*node));
+    return iter != access_records.end() && iter->second.promoted;
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+bool BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::unpromote(const NodePtr& node)
+{
+    if (!is_promoted(node)) {
+        return false;
+    }
+    access_records.at(&(*node)).promoted = false;
+    return true;
+}
+
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+bool BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::pin(const key_type& x)
+    requires OutOfLineValues
+{
+    allocator_type value_alloc{alloc};
+    const auto local = ValueAllocTraits::get_suballocator(value_alloc, purely_local);
+    while (true) {
+        const auto iter = find_impl(x);
+        if (iter == end()) {
+            return false;
+        }
+        auto& elem = iter.node->elems[iter.elem_idx];
+        if (ValueAllocTraits::if_suballocator_contains(value_alloc, local, elem.ptr)) {
+            return true;
+        }
+        relocate_value(elem, local);
+        if (ValueAllocTraits::if_suballocator_contains(value_alloc, local, elem.ptr)) {
+            break;
+        }
+        if (last_local_node == header) {
+            return false;
+        }
+        // The node may hold `x` itself, so `x` is looked up again.
+        relocate_last_local_to_far();
+    }
+    // The nodes evicted may have freed more than the element, which the local prefix takes back,
+    // so that the nodes split later are not allocated in the gap out of it.
+    while (last_local_node != header->prev && relocate_first_far_to_local()) {
+    }
+    return true;
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+bool BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::unpin(const key_type& x)
+    requires OutOfLineValues
+{
+    allocator_type value_alloc{alloc};
+    const auto iter = find_impl(x);
+    if (iter == end()) {
+        return false;
+    }
+    auto& elem = iter.node->elems[iter.elem_idx];
+    if (!ValueAllocTraits::if_suballocator_contains(value_alloc, ValueAllocTraits::get_suballocator(value_alloc, purely_local), elem.ptr)) {
+        return false;
+    }
+    relocate_value(elem, ValueAllocTraits::get_suballocator(value_alloc, swappable_plain));
+    while (last_local_node != header->prev && relocate_first_far_to_local()) {
+    }
+    return true;
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+std::array<size_t, 2> BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::local_footprint()
+{
+    auto local = AllocTraits::get_suballocator(alloc, purely_local);
+
+    // The element in the header is a dummy for `end()`.
+    std::array<size_t, 2> footprint{AllocTraits::if_suballocator_contains(alloc, local, header) ? sizeof(Node) : 0, 0};
+    for (auto node = header->next; node != header; node = node->next) {
+        // the elements of the node held in the purely local region, either in the node or pinned out of line
+        size_t n_local_elems = 0;
+        // the bytes of the node taken by them, which are not the index
+        size_t elem_bytes_in_node = 0;
+        if constexpr (OutOfLineValues) {
+            for (size_t i = 0; i != node->n_elems; i++) {
+                n_local_elems += is_pinned(node->elems[i]);
+            }
+        }
+        if (AllocTraits::if_suballocator_contains(alloc, local, node)) {
+            if constexpr (!OutOfLineValues) {
+                n_local_elems = node->n_elems;
+                elem_bytes_in_node = node->n_elems * sizeof(value_type);
+            }
+            // The unused slots of the node are counted in the index for both layouts.
+            footprint[0] += sizeof(Node) - elem_bytes_in_node;
+        }
+        footprint[1] += n_local_elems * sizeof(value_type);
+    }
+    return footprint;
+}
+
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+bool BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::is_local_prefix_consistent()
+{
+    auto local = AllocTraits::get_suballocator(alloc, purely_local);
+    bool in_prefix = (last_local_node != header);
+    for (auto node = header->next; node != header; node = node->next) {
+        const bool is_local = AllocTraits::if_suballocator_contains(alloc, local, node);
+        if (in_prefix) {
+            if (!is_local) {
+                return false;
+            }
+            in_prefix = (node != last_local_node);
+        } else if (is_local && !is_promoted(node)) {
+            return false;
+        }
+    }
+    // `last_local_node` is in the list
+    return !in_prefix;
+}
+
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+template <std::ranges::input_range R>
+    requires std::ranges::sized_range<R>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::bulk_load_block(R&& sorted)
+{
+    WriterScope scope{*this};
+    bulk_load(std::forward<R>(sorted), false);
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+template <std::ranges::input_range R>
+    requires std::ranges::sized_range<R>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::bulk_load_vEB(R&& sorted)
+{
+    WriterScope scope{*this};
+    bulk_load(std::forward<R>(sorted), true);
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+template <class R>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::bulk_load(R&& sorted, const bool is_vEB)
+{
+    clear_impl();
+    const size_t n = std::ranges::size(sorted);
+    if (n == 0) {
+        return;
+    }
+
+    BulkLoadState state{.max_widths = {1}, .levels = {}, .n_visited = {}, .block = AllocTraits::get_suballocator(alloc, new_per_page)};
+    while (state.max_widths.back() < n + 1) {
+        state.max_widths.push_back(state.max_widths.back() * (MaxNElems + 1));
+    }
+    const size_t height = state.max_widths.size() - 1;
+    state.levels.resize(height);
+    state.n_visited.resize(height);
+
+    // the purely local region is filled in breadth-first order, i.e., in the order of the list
+    const size_t n_local_nodes = [&] {
+        size_t cnt = 0;
+        auto local = AllocTraits::get_suballocator(alloc, purely_local);
+        std::vector<size_t> widths{n + 1}, children_widths;
+        for (size_t depth = 0; depth != height; depth++) {
+            for (const auto width : widths) {
+                auto allocated = SuballocTraits::batch_allocate(local, request::single<Node>());
+                if (!allocated) {
+                    return cnt;
+                }
+                auto& [node] = *allocated;
+                const auto n_children = bulk_load_n_children(width, depth, state);
+                new (&(*node)) Node{.n_elems = (n_children == 0 ? width - 1 : n_children - 1), .children = {}, .parent = nullptr, .prev = nullptr, .next = nullptr};
+                state.levels[depth].push_back(std::move(node));
+                cnt++;
+
+                for (size_t i = 0; i != n_children; i++) {
+                    children_widths.push_back(width / n_children + (i < width % n_children ? 1 : 0));
+                }
+            }
+            widths.swap(children_widths);
+            children_widths.clear();
+        }
+        return cnt;
+    }();
+
+    // the remaining nodes are allocated in the same order as `batch_block()` / `batch_vEB()`
+    if (is_vEB) {
+        bulk_load_vEB_step(n + 1, 0, height, state);
+    } else {
+        bulk_load_block_step(n + 1, 0, state);
+    }
+
+    // linking the nodes level by level
+    for (size_t depth = 0; depth + 1 != height; depth++) {
+        auto child = state.levels[depth + 1].begin();
+        for (auto& node : state.levels[depth]) {
+            for (size_t i = 0; i <= node->n_elems; i++, ++child) {
+                node->children[i] = *child;
+                (*child)->parent = node;
+            }
+        }
+    }
+    NodePtr prev = header;
+    for (auto& level : state.levels) {
+        for (auto& node : level) {
+            node->prev = prev;
+            prev->next = node;
+            prev = node;
+        }
+    }
+    prev->next = header;
+    header->prev = std::move(prev);
+
+    NodePtr root = state.levels.front().front();
+    root->parent = header;
+    latch(header);
+    header->children[0] = root;
+    begin_node = state.levels.back().front();
+    last_local_node = header;
+    for (size_t i = 0; i != n_local_nodes; i++) {
+        last_local_node = last_local_node->next;
+    }
+
+    auto iter = std::ranges::begin(sorted);
+    bulk_load_fill(std::move(root), iter);
+    size_cnt = n;
+    pack_values();
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::bulk_load_n_children(const size_t width, const size_t depth, const BulkLoadState& state) const -> size_t
+{
+    const size_t height = state.max_widths.size() - 1 - depth;
+    if (/* leaf node */ height == 1) {
+        return 0;
+    }
+
+    // as few children as possible, among which the width is distributed evenly
+    const auto max_child_width = state.max_widths[height - 1];
+    return std::max((width + max_child_width - 1) / max_child_width, (depth == 0 ? size_t{2} : MinNElems + 1));
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::bulk_load_place(const size_t width, const size_t depth, BulkLoadState& state)
+{
+    auto& level = state.levels[depth];
+    if (/* allocated in the purely local region */ state.n_visited[depth]++ < level.size()) {
+        return;
+    }
+
+    auto [node] = PageAwarePlacement::place<AllocTraits>(alloc, state.block, SingleObject<Node>{});
+
+    const auto n_children = bulk_load_n_children(width, depth, state);
+    new (&(*node)) Node{.n_elems = (n_children == 0 ? width - 1 : n_children - 1), .children = {}, .parent = nullptr, .prev = nullptr, .next = nullptr};
+    level.push_back(std::move(node));
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::bulk_load_block_step(const size_t width, const size_t depth, BulkLoadState& state)
+{
+    const auto n_children = bulk_load_n_children(width, depth, state);
+    for (size_t i = 0; i != n_children; i++) {
+        bulk_load_block_step(width / n_children + (i < width % n_children ? 1 : 0), depth + 1, state);
+    }
+
+    bulk_load_place(width, depth, state);
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::bulk_load_vEB_step(const size_t width, const size_t depth, const size_t height, BulkLoadState& state)
+{
+    switch (height) {
+    case 0:
+        return;
+    case 1:
+        bulk_load_place(width, depth, state);
+        break;
+
+    default: {
+        const auto upper_height = (height + 1) / 2, lower_height = height - upper_height;
+        bulk_load_vEB_step(width, depth, upper_height, state);
+
+        std::vector<size_t> widths{width}, children_widths;
+        for (size_t down_cnt = 0; down_cnt != upper_height; down_cnt++) {
+            for (const auto w : widths) {
+                const auto n_children = bulk_load_n_children(w, depth + down_cnt, state);
+                for (size_t i = 0; i != n_children; i++) {
+                    children_widths.push_back(w / n_children + (i < w % n_children ? 1 : 0));
+                }
+            }
+            widths.swap(children_widths);
+            children_widths.clear();
+        }
+
+        for (const auto subtree_width : widths) {
+            bulk_load_vEB_step(subtree_width, depth + upper_height, lower_height, state);
+        }
+    } break;
+    }
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+template <class Iter>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::bulk_load_fill(NodePtr node, Iter& iter)
+{
+    for (size_t i = 0; i != node->n_elems; i++, ++iter) {
+        if (/* inner node */ node->children[0] != nullptr) {
+            bulk_load_fill(node->children[i], iter);
+        }
+        node->elems[i].construct(alloc, *iter);
+    }
+    if (/* inner node */ node->children[0] != nullptr) {
+        bulk_load_fill(node->children[node->n_elems], iter);
+    }
+    node->refresh_keys();
+}
+
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+template <size_t PageAlign>
+std::array<size_t, 3> BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::analyze_edges()
 {
     std::array<size_t, 3> res{};
     if (header->children[0] != nullptr) {
@@ -547,9 +1560,9 @@ std::array<size_t, 3> BTreeMap<Key, T, MaxNElems, Compare, Allocator>::analyze_e
     }
     return res;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
 template <size_t PageAlign>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::analyze_edges_step(NodePtr node, std::array<size_t, 3>& acc)
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::analyze_edges_step(NodePtr node, std::array<size_t, 3>& acc)
 {
     if (/* inner node */ node->children[0] != nullptr) {
         auto local = AllocTraits::get_suballocator(alloc, purely_local);
@@ -569,44 +1582,36 @@ void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::analyze_edges_step(NodePtr
     }
 }
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
 template <size_t PageAlign>
-std::array<size_t, 3> BTreeMap<Key, T, MaxNElems, Compare, Allocator>::analyze_locality_in_traversal(size_t cache_size)
+std::array<size_t, 3> BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::analyze_locality_in_traversal(size_t cache_size, PageReplacement policy)
+{
+    PageCacheSimulator cache{cache_size, policy};
+    return analyze_locality_in_traversal<PageAlign>(cache);
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+template <size_t PageAlign>
+std::array<size_t, 3> BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::analyze_locality_in_traversal(PageCacheSimulator& cache)
 {
     std::array<size_t, 3> res{};
     if (header->children[0] != nullptr) {
-        auto cached_pages = std::make_unique<uintptr_t[]>(cache_size);
-        std::fill_n(&cached_pages[0], cache_size, reinterpret_cast<uintptr_t>(nullptr) / PageAlign);
-        size_t lr_cache_idx = 0;
-
-        analyze_locality_in_traversal_step<PageAlign>(header->children[0], &cached_pages[0], cache_size, lr_cache_idx, res);
+        analyze_locality_in_traversal_step<PageAlign>(header->children[0], cache, res);
     }
     return res;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
 template <size_t PageAlign>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::analyze_locality_in_traversal_step(NodePtr node, uintptr_t* const cached_pages, const size_t cache_size, size_t& lr_cache_idx, std::array<size_t, 3>& cnt)
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::analyze_locality_in_traversal_step(NodePtr node, PageCacheSimulator& cache, std::array<size_t, 3>& cnt)
 {
     auto local = AllocTraits::get_suballocator(alloc, purely_local);
     const bool is_node_local = AllocTraits::if_suballocator_contains(alloc, local, node);
 
     const auto page_id = reinterpret_cast<uintptr_t>(&(*node)) / PageAlign;
-    const auto cache_end = cached_pages + cache_size;
     const auto touch_this_node = [&] {
         if (is_node_local) {
             cnt[0]++;
         } else {
-            const bool is_cache_hit = (std::find(cached_pages, cache_end, page_id) != cache_end);
-            cnt[is_cache_hit ? 1 : 2]++;
-
-            if (!is_cache_hit) {
-                cached_pages[lr_cache_idx] = page_id;
-
-                lr_cache_idx++;
-                if (lr_cache_idx == cache_size) {
-                    lr_cache_idx = 0;
-                }
-            }
+            cnt[cache.access(page_id) ? 1 : 2]++;
         }
     };
 
@@ -615,10 +1620,77 @@ void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::analyze_locality_in_traver
         return;
     }
 
-    analyze_locality_in_traversal_step<PageAlign>(node->children[0], cached_pages, cache_size, lr_cache_idx, cnt);
+    analyze_locality_in_traversal_step<PageAlign>(node->children[0], cache, cnt);
     for (size_t i = 1; i <= node->n_elems; i++) {
         touch_this_node();
-        analyze_locality_in_traversal_step<PageAlign>(node->children[i], cached_pages, cache_size, lr_cache_idx, cnt);
+        analyze_locality_in_traversal_step<PageAlign>(node->children[i], cache, cnt);
+    }
+}
+
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+template <class Visit>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::visit_query(const key_type& x, const size_t n_increments, Visit&& visit)
+{
+    auto local = AllocTraits::get_suballocator(alloc, purely_local);
+    allocator_type value_alloc{alloc};
+    const auto value_local = ValueAllocTraits::get_suballocator(value_alloc, purely_local);
+    const auto visit_node = [&](const NodePtr& node) {
+        visit(static_cast<const void*>(&(*node)), AllocTraits::if_suballocator_contains(alloc, local, node));
+    };
+
+    // the descent of `find_impl()`
+    visit_node(header);
+    NodePtr node = header;
+    size_t elem_idx = 0;
+    for (NodePtr cursor = header->children[0]; cursor != nullptr;) {
+        visit_node(cursor);
+        const auto upper_bound = cursor->upper_bound(x, comp);
+        if (upper_bound == 0 || comp(cursor->key(upper_bound - 1), x)) {
+            cursor = cursor->children[upper_bound];
+        } else {
+            node = cursor;
+            elem_idx = upper_bound - 1;
+            break;
+        }
+    }
+
+    // the increments, as `BTreeIterBase::increment()`
+    for (size_t i = 0; node != header; i++) {
+        if constexpr (OutOfLineValues) {
+            const auto& elem = node->elems[elem_idx];
+            visit(static_cast<const void*>(elem.get()), ValueAllocTraits::if_suballocator_contains(value_alloc, value_local, elem.ptr));
+        }
+        if (i == n_increments) {
+            break;
+        }
+
+        const NodePtr& child = node->children[elem_idx + 1];
+        if (child == nullptr) {
+            if (elem_idx + 1 != node->n_elems) {
+                elem_idx++;
+            } else {
+                NodePtr cursor = node;
+                for (;;) {
+                    const NodePtr& parent = cursor->parent;
+                    visit_node(parent);
+                    if (parent->children[parent->n_elems] != cursor) {
+                        break;
+                    }
+                    cursor = parent;
+                }
+                node = cursor->parent;
+                elem_idx = std::ranges::find(node->children, cursor) - node->children.begin();
+            }
+        } else {
+            NodePtr cursor = child;
+            visit_node(cursor);
+            while (cursor->children[0] != nullptr) {
+                cursor = cursor->children[0];
+                visit_node(cursor);
+            }
+            node = cursor;
+            elem_idx = 0;
+        }
     }
 }
 
@@ -53,7 +53,7 @@ void BTreeIterBase<Node>::decrement()
                 cursor = cursor->parent;
             }
             node = cursor->parent;
-            elem_idx = std::ranges::find(node->children, cursor) - node->children.begin() + 1;
+            elem_idx = std::ranges::find(node->children, cursor) - node->children.begin() - 1;
         }
 
     } else if (node->parent == nullptr) {  // the node is the header
@@ -71,54 +71,54 @@ void BTreeIterBase<Node>::decrement()
 }
 
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::iterator::operator++() -> iterator&
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::iterator::operator++() -> iterator&
 {
     Base::increment();
     return *this;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::iterator::operator++(int) -> iterator
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::iterator::operator++(int) -> iterator
 {
     auto tmp = *this;
     ++(*this);
     return tmp;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::iterator::operator--() -> iterator&
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::iterator::operator--() -> iterator&
 {
     Base::decrement();
     return *this;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::iterator::operator--(int) -> iterator
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::iterator::operator--(int) -> iterator
 {
     auto tmp = *this;
     --(*this);
     return tmp;
 }
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::const_iterator::operator++() -> const_iterator&
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::const_iterator::operator++() -> const_iterator&
 {
     Base::increment();
     return *this;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::const_iterator::operator++(int) -> const_iterator
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::const_iterator::operator++(int) -> const_iterator
 {
     auto tmp = *this;
     ++(*this);
     return tmp;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::const_iterator::operator--() -> const_iterator&
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::const_iterator::operator--() -> const_iterator&
 {
     Base::decrement();
     return *this;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::const_iterator::operator--(int) -> const_iterator
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Concurrent, SeparateKeys, OutOfLineValues>::const_iterator::operator--(int) -> const_iterator
 {
     auto tmp = *this;
     --(*this);
@@ -9,20 +9,42 @@
 namespace FarMemoryContainer::Blocked
 {
 
-template <class PtrToVal, size_t MaxNElems>
+template <class PtrToVal, size_t MaxNElems, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+auto BTreeNode<PtrToVal, MaxNElems, Concurrent, SeparateKeys, OutOfLineValues>::key(const size_t idx) const -> const key_type&
+{
+    if constexpr (OutOfLineValues) {
+        return elems[idx].key;
+    } else {
+        return elems[idx].get()->first;
+    }
+}
+template <class PtrToVal, size_t MaxNElems, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
 template <class Key, class key_compare>
-size_t BTreeNode<PtrToVal, MaxNElems>::upper_bound(const Key& key, key_compare& comp) const
+size_t BTreeNode<PtrToVal, MaxNElems, Concurrent, SeparateKeys, OutOfLineValues>::upper_bound(const Key& key, key_compare& comp, const size_t n) const
 {
-    const auto num_comp = std::bit_width(n_elems);
-    const size_t first_idx = n_elems - (size_t(1) << (num_comp - 1));
-    size_t pos = (comp(key, elems[first_idx].get()->first) ? 0 : first_idx + 1);
-
-    for (size_t i = num_comp - 1; i != 0; i--) {
-        const size_t step = size_t(1) << (i - 1);
-        pos = (comp(key, elems[pos + step - 1].get()->first) ? pos : pos + step);
+    if constexpr (SeparateKeys) {
+        return upper_bound_in_keys(keys.keys, n, key, comp);
+    } else {
+        const auto num_comp = std::bit_width(n);
+        const size_t first_idx = n - (size_t(1) << (num_comp - 1));
+        size_t pos = (comp(key, this->key(first_idx)) ? 0 : first_idx + 1);
+
+        for (size_t i = num_comp - 1; i != 0; i--) {
+            const size_t step = size_t(1) << (i - 1);
+            pos = (comp(key, this->key(pos + step - 1)) ? pos : pos + step);
+        }
+
+        return pos;
+    }
+}
+template <class PtrToVal, size_t MaxNElems, bool Concurrent, bool SeparateKeys, bool OutOfLineValues>
+void BTreeNode<PtrToVal, MaxNElems, Concurrent, SeparateKeys, OutOfLineValues>::refresh_keys()
+{
+    if constexpr (SeparateKeys) {
+        for (size_t i = 0; i != n_elems; i++) {
+            keys.keys[i] = key(i);
+        }
     }
-
-    return pos;
 }
 
 }  // namespace FarMemoryContainer::Blocked
@@ -2,6 +2,12 @@
 
 #include <farmalloc/collective_allocator_traits.hpp>
 #include <far_memory_container/aligned_buffer.hpp>
+#include <far_memory_container/epoch_based_reclamation.hpp>
+#include <far_memory_container/interleaved_lookup.hpp>
+#include <far_memory_container/optimistic_lock.hpp>
+#include <far_memory_container/page_cache_simulator.hpp>
+#include <far_memory_container/placement.hpp>
+#include <far_memory_container/published_pointer.hpp>
 
 #include <algorithm>
 #include <array>
@@ -11,28 +17,37 @@
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <new>
 #include <optional>
 #include <random>
+#include <ranges>
+#include <span>
+#include <tuple>
 #include <type_traits>
+#include <variant>
+#include <vector>
 
 
 namespace FarMemoryContainer::Blocked
 {
 
-template <class PtrToVal>
+template <class PtrToVal, bool Concurrent = false>
 struct SkiplistNode {
     using value_type = std::remove_reference_t<decltype(*std::declval<PtrToVal>())>;
     using NodePtr = typename std::pointer_traits<PtrToVal>::template rebind<SkiplistNode>;
     using level_type = uint8_t;
 
     struct Link {
-        NodePtr prev = nullptr, next = nullptr;
+        // The readers concurrent with a writer follow the links without any lock.
+        using Ptr = std::conditional_t<Concurrent, PublishedPointer<NodePtr>, NodePtr>;
+        Ptr prev = nullptr, next = nullptr;
     };
     using LinkPtr = typename std::pointer_traits<PtrToVal>::template rebind<Link>;
 
     LinkPtr links;
     AlignedBuffer<value_type> value;
+    [[no_unique_address]] std::conditional_t<Concurrent, OptimisticVersion, NoVersion> version{};
 
 private:
     level_type level_;
@@ -78,6 +93,7 @@ protected:
     constexpr explicit SkiplistIteratorBase(const NodePtr& node) noexcept : node(node) {}
 
     constexpr value_type* get() const noexcept { return node->value.get(); }
+    constexpr const NodePtr& get_node() const noexcept { return node; }
 
     inline constexpr SkiplistIteratorBase& operator++() noexcept;
     inline constexpr SkiplistIteratorBase& operator--() noexcept;
@@ -94,7 +110,12 @@ private:
     std::uniform_int_distribution<uint64_t> impl_dist;
 };
 
-template <class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<std::pair<const Key, T>>, std::uniform_random_bit_generator URBG = std::minstd_rand0>
+//! @tparam Concurrent enables `lookup()` concurrent with the other operations.
+//! The readers in `lookup()` follow the links without any lock, and the writers are serialized.
+//! A writer publishes a node by storing the pointers to it after initializing it,
+//! and the nodes unlinked, e.g., relocated ones, are reclaimed after the readers leave them.
+//! The other readers, i.e., `find()` and the iterators, are not protected against the writers.
+template <class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<std::pair<const Key, T>>, std::uniform_random_bit_generator URBG = std::minstd_rand0, bool Concurrent = false>
 struct SkiplistMap {
     using key_type = Key;
     using mapped_type = T;
@@ -107,6 +128,8 @@ struct SkiplistMap {
     using const_reference = const value_type&;
 
     static_assert(std::is_same_v<typename FarMalloc::collective_allocator_traits<allocator_type>::value_type, value_type>);
+    // The readers may copy a value being overwritten, and discard it after failing validation.
+    static_assert(!Concurrent || (std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<T>));
 
     struct value_compare {
     private:
@@ -123,7 +146,7 @@ struct SkiplistMap {
     };
 
 private:
-    using Node = SkiplistNode<typename FarMalloc::collective_allocator_traits<allocator_type>::pointer>;
+    using Node = SkiplistNode<typename FarMalloc::collective_allocator_traits<allocator_type>::pointer, Concurrent>;
     using Link = typename Node::Link;
     using LinkPtr = typename Node::LinkPtr;
     using NodeAllocTraits = typename FarMalloc::collective_allocator_traits<allocator_type>::template rebind_traits<Node>;
@@ -227,6 +250,10 @@ private:
     }();
     NodePtr last_local_node = header;
 
+    // concurrency control (only if `Concurrent`)
+    [[no_unique_address]] std::conditional_t<Concurrent, std::mutex, std::monostate> writer_mutex;
+    [[no_unique_address]] mutable std::conditional_t<Concurrent, EpochManager, std::monostate> epoch_manager;
+
 public:
     constexpr SkiplistMap() {}
     constexpr SkiplistMap(const Allocator& alloc) : node_alloc(alloc) {}
@@ -256,52 +283,116 @@ public:
 
     inline constexpr iterator find(const key_type& x) { return find_impl(x); }
     inline constexpr const_iterator find(const key_type& x) const { return find_impl(x); }
+    //! finger search from `hint`, e.g., the result of the previous lookup
+    //! It climbs from `hint` only as high as needed, so that the nodes touched are logarithmic in the distance to the result, not in the size.
+    //! @return the first element not less than `x`
+    inline constexpr iterator lower_bound(const_iterator hint, const key_type& x) { return iterator(lower_bound_impl(hint.get_node(), x)); }
+    inline constexpr iterator find(const_iterator hint, const key_type& x);
+    //! @return a copy of the mapped value of `x`, safe against the concurrent writers if `Concurrent`
+    inline std::optional<mapped_type> lookup(const key_type& x) const;
+    //! calls `f` with at most `n` elements in ascending order from that of `from_key`, as `find(from_key)` followed by increments
+    //! On each node, `prefetch(address, size)` is called for the swappable nodes its upper links point to,
+    //! about 2, 4, 8, ... nodes ahead, within the rest of the scan, so that swapping them in overlaps.
+    //! @return the number of the elements visited, 0 if `from_key` does not exist
+    template <class F, class Prefetch>
+    inline size_t scan(const key_type& from_key, size_t n, F&& f, Prefetch&& prefetch);
+    //! finds each of `keys` into `out` as `find()`, interleaving the lookups (see `interleave_lookups()`)
+    //! Each node whose key is to be compared is prefetched into the cache, and `prefetch(address, size)` is called for it if it is swappable.
+    template <class Prefetch = NoPrefetch>
+    inline void multi_find(std::span<const key_type> keys, std::span<iterator> out, Prefetch&& prefetch = {});
 
     inline constexpr std::pair<iterator, bool> insert(value_type&& x);
     inline constexpr size_type erase(const key_type& x);
+    //! replaces the mapped value of `x` if exists
+    //! @return whether `x` exists
+    inline bool update(const key_type& x, const mapped_type& obj);
 
     inline constexpr void clear() noexcept;
 
     inline void batch_block();
+    //! rearranges the nodes in the van Emde Boas layout of the implicit tree, where the parent of a node is
+    //! the nearest preceding one of a higher level. The levels are halved recursively, and the upper half is placed
+    //! before the subtrees of the lower half, each of which lies between two consecutive nodes of the upper half,
+    //! so that the nodes visited by a search from the top level are clustered in a few pages.
+    inline void batch_vEB();
+
+    //! Replace the contents with the elements of `sorted`, which must be in strictly ascending order of the keys.
+    //! The nodes are allocated directly in the placement that `batch_block()` would rearrange them into,
+    //! so that no rearrangement is needed afterwards.
+    template <std::ranges::input_range R>
+        requires std::ranges::sized_range<R>
+    inline void bulk_load(R&& sorted);
 
     //! @return [purely_local_edges, same_page_edges, diff_pages_edges]
     template <size_t PageAlign>
     inline std::array<size_t, 3> analyze_edges();
+    //! simulates the page cache during a traversal in the ascending order of the keys
     //! @return [purely_local, cache_hit, cache_miss]
     template <size_t PageAlign>
-    inline std::array<size_t, 3> analyze_locality_in_traversal(size_t cache_size_in_pages);
+    inline std::array<size_t, 3> analyze_locality_in_traversal(size_t cache_size_in_pages, PageReplacement policy = PageReplacement::FIFO);
+    //! @param cache may be shared with the other analyses, e.g., warmed up by them
+    template <size_t PageAlign>
+    inline std::array<size_t, 3> analyze_locality_in_traversal(PageCacheSimulator& cache);
+    //! calls `visit(address, is_local)` for each node which `find(x)` followed by `n_increments` increments of the iterator visits,
+    //! in the order of the accesses, e.g., to record a trace (see `AccessTraceWriter`)
+    template <class Visit>
+    inline void visit_query(const key_type& x, size_t n_increments, Visit&& visit);
 
 private:
     inline constexpr void clear_impl() noexcept;
+    //! destroys the nodes from `node` to the first one in the key order
+    inline constexpr void destroy_nodes(NodePtr node) noexcept;
+
+    //! serializes the writers
+    struct WriterScope {
+        SkiplistMap& map;
+        inline explicit WriterScope(SkiplistMap& map);
+        inline ~WriterScope();
+    };
+    //! destroys a node unlinked from the list, after the concurrent readers leave it
+    inline void dispose(NodePtr node);
 
     template <class K>
     inline constexpr NodePtr lower_bound_impl(const K& x) const;
+    //! `lower_bound_impl()` starting at `level` from `lower_bound`, which is preceded by `prev_in_upper_level` in the list of `level`
+    template <class K>
+    inline constexpr NodePtr lower_bound_impl(NodePtr lower_bound, NodePtr prev_in_upper_level, level_type level, const K& x) const;
+    template <class K>
+    inline constexpr NodePtr lower_bound_impl(const NodePtr& finger, const K& x) const;
     template <class K>
     inline constexpr iterator find_impl(const K& x) const;
 
     inline constexpr NodePtr prev_in_priority(NodePtr candidate, level_type level);
     inline constexpr std::optional<NodePtr> next_in_priority(NodePtr candidate, level_type level);
     inline NodePtr relocate_last_local_to_far();
-    inline void relocate(NodePtr& node, NodeSuballoc suballoc);
+    //! @return whether `node` has been relocated, i.e., `suballoc` has had room for it
+    //! @throw std::bad_alloc if `Concurrent` and `suballoc` has no room for it
+    inline bool relocate(NodePtr& node, NodeSuballoc suballoc);
+    //! relocates a swappable `node` next to the nodes relocated into `block` before, or into a new page if it does not fit
+    //! It stays where it is if it does not fit in a page at all.
+    inline void relocate_into_block(NodePtr& node, NodeSuballoc& block);
+
+    //! places the nodes of the levels [`lowest`, `highest`] between `first` and `last`, whose levels are at least `highest`
+    inline void batch_vEB_step(NodePtr first, NodePtr last, level_type lowest, level_type highest, NodeSuballoc& block);
 };
 
 
-template <class PtrToVal>
-constexpr SkiplistNode<PtrToVal>::SkiplistNode(const NodePtr& ptr_to_this, LinkPtr&& links) noexcept
+template <class PtrToVal, bool Concurrent>
+constexpr SkiplistNode<PtrToVal, Concurrent>::SkiplistNode(const NodePtr& ptr_to_this, LinkPtr&& links) noexcept
     : links(std::move(links)), level_(SkiplistLevelDistribution::MaxLevel)
 {
     std::uninitialized_fill_n(links, level_ + 1, Link(ptr_to_this, ptr_to_this));
 }
-template <class PtrToVal>
+template <class PtrToVal, bool Concurrent>
 template <class Alloc, class... Args>
-constexpr SkiplistNode<PtrToVal>::SkiplistNode(Alloc& allocator, const LinkPtr& links, level_type level, Args&&... args)
+constexpr SkiplistNode<PtrToVal, Concurrent>::SkiplistNode(Alloc& allocator, const LinkPtr& links, level_type level, Args&&... args)
     : links(links), level_(level)
 {
     value.construct(allocator, std::forward<Args>(args)...);
 }
-template <class PtrToVal>
+template <class PtrToVal, bool Concurrent>
 template <class Alloc>
-constexpr SkiplistNode<PtrToVal>::SkiplistNode(Alloc& allocator, SkiplistNode&& other)
+constexpr SkiplistNode<PtrToVal, Concurrent>::SkiplistNode(Alloc& allocator, SkiplistNode&& other)
     : links(std::move(other.links)), level_(other.level_)
 {
     value.move_from(allocator, other.value);
@@ -321,54 +412,54 @@ constexpr auto SkiplistIteratorBase<Node_>::operator--() noexcept -> SkiplistIte
     return *this;
 }
 
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::iterator::operator++() -> iterator&
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::iterator::operator++() -> iterator&
 {
     Base::operator++();
     return *this;
 }
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::iterator::operator++(int) -> iterator
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::iterator::operator++(int) -> iterator
 {
     iterator tmp = *this;
     ++(*this);
     return tmp;
 }
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::iterator::operator--() -> iterator&
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::iterator::operator--() -> iterator&
 {
     Base::operator--();
     return *this;
 }
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::iterator::operator--(int) -> iterator
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::iterator::operator--(int) -> iterator
 {
     iterator tmp = *this;
     --(*this);
     return tmp;
 }
 
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::const_iterator::operator++() -> const_iterator&
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::const_iterator::operator++() -> const_iterator&
 {
     Base::operator++();
     return *this;
 }
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::const_iterator::operator++(int) -> const_iterator
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::const_iterator::operator++(int) -> const_iterator
 {
     const_iterator tmp = *this;
     ++(*this);
     return tmp;
 }
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::const_iterator::operator--() -> const_iterator&
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::const_iterator::operator--() -> const_iterator&
 {
     Base::operator--();
     return *this;
 }
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::const_iterator::operator--(int) -> const_iterator
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::const_iterator::operator--(int) -> const_iterator
 {
     const_iterator tmp = *this;
     --(*this);
@@ -385,10 +476,13 @@ constexpr auto SkiplistLevelDistribution::operator()(URBG&& g) -> result_type
 }
 
 
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-constexpr SkiplistMap<Key, T, Compare, Allocator, URBG>::~SkiplistMap() noexcept
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+constexpr SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::~SkiplistMap() noexcept
 {
     clear_impl();
+    if constexpr (Concurrent) {
+        epoch_manager.reclaim_all();
+    }
 
     std::destroy_n(header->links, SkiplistLevelDistribution::MaxLevel + 1);
     LinkAllocTraits::deallocate(link_alloc, std::move(header->links), SkiplistLevelDistribution::MaxLevel + 1);
@@ -397,18 +491,29 @@ constexpr SkiplistMap<Key, T, Compare, Allocator, URBG>::~SkiplistMap() noexcept
     header->~Node();
     NodeAllocTraits::deallocate(node_alloc, std::move(header), 1);
 }
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-constexpr void SkiplistMap<Key, T, Compare, Allocator, URBG>::clear() noexcept
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+constexpr void SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::clear() noexcept
 {
+    WriterScope scope{*this};
     clear_impl();
-    size_cnt = 0;
+}
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+constexpr void SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::clear_impl() noexcept
+{
+    NodePtr last = header->links[0].prev;
     std::fill_n(header->links, SkiplistLevelDistribution::MaxLevel + 1, Link(header, header));
+    if constexpr (Concurrent) {
+        // All the nodes are unlinked at once, and destroyed after the readers leave them.
+        epoch_manager.synchronize();
+    }
+    destroy_nodes(std::move(last));
+
+    size_cnt = 0;
     last_local_node = header;
 }
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-constexpr void SkiplistMap<Key, T, Compare, Allocator, URBG>::clear_impl() noexcept
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+constexpr void SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::destroy_nodes(NodePtr node) noexcept
 {
-    NodePtr node = header->links[0].prev;
     while (node != header) {
         NodePtr deleted = std::move(node);
         node = deleted->links[0].prev;
@@ -422,13 +527,16 @@ constexpr void SkiplistMap<Key, T, Compare, Allocator, URBG>::clear_impl() noexc
     }
 }
 
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
 template <class K>
-constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::lower_bound_impl(const K& key) const -> NodePtr
+constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::lower_bound_impl(const K& key) const -> NodePtr
+{
+    return lower_bound_impl(header, header, header->level(), key);
+}
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+template <class K>
+constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::lower_bound_impl(NodePtr lower_bound, NodePtr prev_in_upper_level, level_type level, const K& key) const -> NodePtr
 {
-    NodePtr lower_bound = header, prev_in_upper_level = header;
-
-    level_type level = lower_bound->level();
     do {
         for (;;) {
             NodePtr prev = lower_bound->links[level].prev;
@@ -447,9 +555,46 @@ constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::lower_bound_impl(c
 
     return lower_bound;
 }
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
 template <class K>
-constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::find_impl(const K& key) const -> iterator
+constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::lower_bound_impl(const NodePtr& finger, const K& key) const -> NodePtr
+{
+    if (finger == header) {
+        return lower_bound_impl(key);
+    }
+
+    // Climbing up whenever the current node is high enough, walk toward `key` until the link of `level` steps over it.
+    // Then the nodes on both sides of the link bound the search down from `level`.
+    level_type level = 0;
+    if (comp(finger->value.get()->first, key)) {
+        NodePtr left = finger;
+        for (;;) {
+            NodePtr next = left->links[level].next;
+            if (next == header || !comp(next->value.get()->first, key)) {
+                return lower_bound_impl(std::move(next), std::move(left), level, key);
+            }
+            left = std::move(next);
+            if (left->level() > level) {
+                level++;
+            }
+        }
+    } else {
+        NodePtr right = finger;
+        for (;;) {
+            NodePtr prev = right->links[level].prev;
+            if (prev == header || comp(prev->value.get()->first, key)) {
+                return lower_bound_impl(std::move(right), std::move(prev), level, key);
+            }
+            right = std::move(prev);
+            if (right->level() > level) {
+                level++;
+            }
+        }
+    }
+}
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+template <class K>
+constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::find_impl(const K& key) const -> iterator
 {
     auto lower_bound = lower_bound_impl(key);
     if (lower_bound != header && !comp(key, lower_bound->value.get()->first)) {
@@ -458,11 +603,170 @@ constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::find_impl(const K&
         return iterator(header);
     }
 }
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::find(const_iterator hint, const key_type& x) -> iterator
+{
+    auto lower_bound = lower_bound_impl(hint.get_node(), x);
+    if (lower_bound != header && !comp(x, lower_bound->value.get()->first)) {
+        return iterator(std::move(lower_bound));
+    } else {
+        return iterator(header);
+    }
+}
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::lookup(const key_type& x) const -> std::optional<mapped_type>
+{
+    if constexpr (Concurrent) {
+        for (;;) {
+            // re-pinned on every restart so that a writer waiting for a grace period is not blocked
+            [[maybe_unused]] const auto guard = epoch_manager.pin();
+            const auto lower_bound = lower_bound_impl(x);
+            if (lower_bound == header || comp(x, lower_bound->value.get()->first)) {
+                return std::nullopt;
+            }
+            const auto version = lower_bound->version.read_begin();
+            if (!version) {
+                continue;
+            }
+            std::optional<mapped_type> res{lower_bound->value.get()->second};
+            if (lower_bound->version.read_validate(*version)) {
+                return res;
+            }
+        }
+    } else {
+        const auto iter = find_impl(x);
+        if (iter == end()) {
+            return std::nullopt;
+        }
+        return iter->second;
+    }
+}
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+template <class F, class Prefetch>
+size_t SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::scan(const key_type& from_key, const size_t n, F&& f, Prefetch&& prefetch)
+{
+    NodePtr node = lower_bound_impl(from_key);
+    if (node == header || comp(from_key, node->value.get()->first)) {
+        return 0;
+    }
+    auto local = NodeAllocTraits::get_suballocator(node_alloc, purely_local);
+
+    size_t cnt = 0;
+    for (; cnt != n && node != header; cnt++) {
+        // The link of level `lv` skips 2^lv nodes on average.
+        for (level_type lv = 1; lv <= node->level() && (size_t{1} << lv) < n - cnt; lv++) {
+            if (const NodePtr ahead = node->links[lv].next;
+                ahead != header && !NodeAllocTraits::if_suballocator_contains(node_alloc, local, ahead)) {
+                prefetch(static_cast<const void*>(&(*ahead)), sizeof(Node));
+            }
+        }
+        f(*node->value.get());
+        node = node->links[0].next;
+    }
+    return cnt;
+}
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+template <class Prefetch>
+void SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::multi_find(std::span<const key_type> keys, std::span<iterator> out, Prefetch&& prefetch)
+{
+    auto local = NodeAllocTraits::get_suballocator(node_alloc, purely_local);
+
+    // a lookup of `keys[idx]` as `lower_bound_impl()`, about to compare the key of `prev`
+    struct State {
+        size_t idx;
+        NodePtr lower_bound, prev_in_upper_level, prev;
+        level_type level;
+    };
+    // down to the next node to compare, which is hinted
+    // @return whether there is such a node, i.e., the lookup has not finished
+    const auto advance = [&](State& state) {
+        for (;;) {
+            state.prev = state.lower_bound->links[state.level].prev;
+            if (state.prev != state.prev_in_upper_level) {
+                __builtin_prefetch(&(*state.prev));
+                if (!NodeAllocTraits::if_suballocator_contains(node_alloc, local, state.prev)) {
+                    prefetch(static_cast<const void*>(&(*state.prev)), sizeof(Node));
+                }
+                return true;
+            }
+            if (state.level-- == 0) {
+                return false;
+            }
+        }
+    };
+    const auto finish = [&](State& state) {
+        const auto& x = keys[state.idx];
+        if (state.lower_bound != header && !comp(x, state.lower_bound->value.get()->first)) {
+            out[state.idx] = iterator(std::move(state.lower_bound));
+        } else {
+            out[state.idx] = iterator(header);
+        }
+        return false;
+    };
+
+    interleave_lookups<State>(
+        keys.size(),
+        [&](State& state, const size_t idx) {
+            state = {.idx = idx, .lower_bound = header, .prev_in_upper_level = header, .prev = nullptr, .level = header->level()};
+            return advance(state) || finish(state);
+        },
+        [&](State& state) {
+            if (comp(state.prev->value.get()->first, keys[state.idx])) {
+                state.prev_in_upper_level = std::move(state.prev);
+                if (state.level-- == 0) {
+                    return finish(state);
+                }
+            } else {
+                state.lower_bound = std::move(state.prev);
+            }
+            return advance(state) || finish(state);
+        });
+}
+
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::WriterScope::WriterScope(SkiplistMap& map) : map(map)
+{
+    if constexpr (Concurrent) {
+        map.writer_mutex.lock();
+    }
+}
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::WriterScope::~WriterScope()
+{
+    if constexpr (Concurrent) {
+        map.epoch_manager.collect();
+        map.writer_mutex.unlock();
+    }
+}
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+void SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::dispose(NodePtr node)
+{
+    const auto destroy = [this](NodePtr node) {
+        std::destroy_n(node->links, node->level() + 1);
+        LinkAllocTraits::deallocate(link_alloc, std::move(node->links), node->level() + 1);
+
+        node->value.destroy(node_alloc);
+        node->~Node();
+        NodeAllocTraits::deallocate(node_alloc, std::move(node), 1);
+    };
+
+    if constexpr (Concurrent) {
+        const bool is_local = NodeAllocTraits::if_suballocator_contains(node_alloc, NodeAllocTraits::get_suballocator(node_alloc, purely_local), node);
+        epoch_manager.retire([destroy, node] { destroy(node); });
+        if (is_local) {
+            // The local memory is made available at once, because the placement assumes that the freed node can be reused right after.
+            epoch_manager.synchronize();
+        }
+    } else {
+        destroy(std::move(node));
+    }
+}
 
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::insert(value_type&& x) -> std::pair<iterator, bool>
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::insert(value_type&& x) -> std::pair<iterator, bool>
 {
     using namespace FarMalloc::request;
+    WriterScope scope{*this};
 
     const level_type new_lv = dist(urbg);
 
@@ -561,9 +865,10 @@ constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::insert(value_type&
     return std::make_pair(iterator(node), true);
 }
 
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::erase(const key_type& x) -> size_type
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::erase(const key_type& x) -> size_type
 {
+    WriterScope scope{*this};
     auto deleted = lower_bound_impl(x);
     if (deleted != header && !comp(x, deleted->value.get()->first)) {
         if (deleted == last_local_node) {
@@ -575,12 +880,7 @@ constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::erase(const key_ty
             deleted->links[level].next->links[level].prev = deleted->links[level].prev;
         }
 
-        std::destroy_n(deleted->links, deleted->level() + 1);
-        LinkAllocTraits::deallocate(link_alloc, std::move(deleted->links), deleted->level() + 1);
-
-        deleted->value.destroy(node_alloc);
-        deleted->~Node();
-        NodeAllocTraits::deallocate(node_alloc, std::move(deleted), 1);
+        dispose(std::move(deleted));
 
         try {
             for (;;) {
@@ -588,7 +888,9 @@ constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::erase(const key_ty
                 if (!one_less_prioritized) {
                     break;
                 }
-                relocate(*one_less_prioritized, NodeAllocTraits::get_suballocator(node_alloc, purely_local));
+                if (!relocate(*one_less_prioritized, NodeAllocTraits::get_suballocator(node_alloc, purely_local))) {
+                    break;
+                }
                 last_local_node = *one_less_prioritized;
             }
         } catch (std::bad_alloc&) {
@@ -601,9 +903,26 @@ constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::erase(const key_ty
         return 0;
     }
 }
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+bool SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::update(const key_type& x, const mapped_type& obj)
+{
+    WriterScope scope{*this};
+    const auto lower_bound = lower_bound_impl(x);
+    if (lower_bound == header || comp(x, lower_bound->value.get()->first)) {
+        return false;
+    }
+    if constexpr (Concurrent) {
+        lower_bound->version.latch();
+    }
+    lower_bound->value.get()->second = obj;
+    if constexpr (Concurrent) {
+        lower_bound->version.unlatch();
+    }
+    return true;
+}
 
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::prev_in_priority(NodePtr candidate, level_type level) -> NodePtr
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::prev_in_priority(NodePtr candidate, level_type level) -> NodePtr
 {
     for (;;) {
         for (; candidate != header; candidate = candidate->links[level].next) {
@@ -617,8 +936,8 @@ constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::prev_in_priority(N
         candidate = candidate->links[level].next;
     }
 }
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::next_in_priority(NodePtr candidate, level_type level) -> std::optional<NodePtr>
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::next_in_priority(NodePtr candidate, level_type level) -> std::optional<NodePtr>
 {
     for (;;) {
         for (; candidate != header; candidate = candidate->links[level].prev) {
@@ -635,41 +954,61 @@ constexpr auto SkiplistMap<Key, T, Compare, Allocator, URBG>::next_in_priority(N
         candidate = candidate->links[level].prev;
     }
 }
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-auto SkiplistMap<Key, T, Compare, Allocator, URBG>::relocate_last_local_to_far() -> NodePtr
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+auto SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::relocate_last_local_to_far() -> NodePtr
 {
     NodePtr node = std::move(last_local_node);
     last_local_node = prev_in_priority(node->links[node->level()].next, node->level());
     relocate(node, NodeAllocTraits::get_suballocator(node_alloc, swappable_plain));
     return node;
 }
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-void SkiplistMap<Key, T, Compare, Allocator, URBG>::relocate(NodePtr& node, NodeSuballoc suballoc)
-{
-    LinkPtr links = node->links;
-    if (NodeAllocTraits::relocate(
-            node_alloc, suballoc, [this](auto* from, auto n, auto* to) {
-                if constexpr (std::same_as<decltype(from), Node*>) {
-                    new (to) Node{node_alloc, std::move(*from)};
-                    from->~Node();
-                } else {
-                    static_assert(std::same_as<decltype(from), Link*>);
-                    std::uninitialized_move_n(from, n, to);
-                    std::destroy_n(from, n);
-                }
-            },
-            std::tie(node, links), request::single<Node>(), request::dynamic<Link>(node->level() + 1))) {
-
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+bool SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::relocate(NodePtr& node, NodeSuballoc suballoc)
+{
+    if constexpr (Concurrent) {
+        // The original node is left to the readers that have reached it, and reclaimed after they leave.
+        auto allocated = NodeSuballocTraits::batch_allocate(suballoc, request::single<Node>(), request::dynamic<Link>(node->level() + 1));
+        if (!allocated) {
+            throw std::bad_alloc{};
+        }
+        auto& [relocated, links] = *allocated;
+        std::uninitialized_copy_n(node->links, node->level() + 1, links);
+        new (&(*relocated)) Node{node_alloc, links, node->level(), *node->value.get()};
         for (level_type level = 0; level <= node->level(); level++) {
-            links[level].prev->links[level].next = links[level].next->links[level].prev = node;
+            links[level].prev->links[level].next = links[level].next->links[level].prev = relocated;
+        }
+        dispose(std::exchange(node, relocated));
+        return true;
+
+    } else {
+        LinkPtr links = node->links;
+        if (NodeAllocTraits::relocate(
+                node_alloc, suballoc, [this](auto* from, auto n, auto* to) {
+                    if constexpr (std::same_as<decltype(from), Node*>) {
+                        new (to) Node{node_alloc, std::move(*from)};
+                        from->~Node();
+                    } else {
+                        static_assert(std::same_as<decltype(from), Link*>);
+                        std::uninitialized_move_n(from, n, to);
+                        std::destroy_n(from, n);
+                    }
+                },
+                std::tie(node, links), request::single<Node>(), request::dynamic<Link>(node->level() + 1))) {
+
+            for (level_type level = 0; level <= node->level(); level++) {
+                links[level].prev->links[level].next = links[level].next->links[level].prev = node;
+            }
+            node->links = std::move(links);
+            return true;
         }
-        node->links = std::move(links);
+        return false;
     }
 }
 
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
-void SkiplistMap<Key, T, Compare, Allocator, URBG>::batch_block()
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+void SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::batch_block()
 {
+    WriterScope scope{*this};
     if (prev_in_priority(header->links[0].next, 0) == last_local_node) {
         return;
     }
@@ -679,23 +1018,133 @@ void SkiplistMap<Key, T, Compare, Allocator, URBG>::batch_block()
     NodePtr node = header->links[0].prev;
     while (node != header) {
         if (!NodeAllocTraits::if_suballocator_contains(node_alloc, local, node)) {
-            if (!NodeSuballocTraits::is_occupancy_under(block, 0.7)) {
-                block = NodeAllocTraits::get_suballocator(node_alloc, new_per_page);
+            relocate_into_block(node, block);
+        }
+        node = node->links[0].prev;
+    }
+}
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+void SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::relocate_into_block(NodePtr& node, NodeSuballoc& block)
+{
+    PageAwarePlacement::relocate_by<NodeAllocTraits>(node_alloc, block, [&](NodeSuballoc& suballoc) { return relocate(node, suballoc); });
+}
+
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+void SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::batch_vEB()
+{
+    WriterScope scope{*this};
+    if (prev_in_priority(header->links[0].next, 0) == last_local_node) {
+        return;
+    }
+    level_type highest = SkiplistLevelDistribution::MaxLevel;
+    while (highest != 0 && header->links[highest].next == header) {
+        highest--;
+    }
+    auto block = NodeAllocTraits::get_suballocator(node_alloc, new_per_page);
+    batch_vEB_step(header, header, 0, highest, block);
+}
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+void SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::batch_vEB_step(NodePtr first, NodePtr last, const level_type lowest, const level_type highest, NodeSuballoc& block)
+{
+    if (lowest == highest) {
+        // the nodes between `first` and `last` in the list of `lowest` are exactly those of `lowest`
+        auto local = NodeAllocTraits::get_suballocator(node_alloc, purely_local);
+        for (NodePtr node = first->links[lowest].next; node != last; node = node->links[lowest].next) {
+            if (!NodeAllocTraits::if_suballocator_contains(node_alloc, local, node)) {
+                relocate_into_block(node, block);
             }
-            try {
-                relocate(node, block);
-            } catch (std::bad_alloc&) {
-                block = NodeAllocTraits::get_suballocator(node_alloc, new_per_page);
-                relocate(node, block);
+        }
+        return;
+    }
+
+    const level_type n_upper_levels = (highest - lowest + 2) / 2, lowest_upper = highest - n_upper_levels + 1;
+    batch_vEB_step(first, last, lowest_upper, highest, block);
+    // The nodes of the upper levels are not relocated any more, and bound the subtrees of the lower levels.
+    // `first` and `last` are the same header at the top.
+    NodePtr bound = first;
+    do {
+        NodePtr next_bound = bound->links[lowest_upper].next;
+        batch_vEB_step(bound, next_bound, lowest, lowest_upper - 1, block);
+        bound = std::move(next_bound);
+    } while (bound != last);
+}
+
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+template <std::ranges::input_range R>
+    requires std::ranges::sized_range<R>
+void SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::bulk_load(R&& sorted)
+{
+    using namespace FarMalloc::request;
+    constexpr size_t NLevels = SkiplistLevelDistribution::MaxLevel + 1;
+
+    WriterScope scope{*this};
+    clear_impl();
+    const size_t n = std::ranges::size(sorted);
+
+    std::vector<level_type> levels(n);
+    std::array<size_t, NLevels> n_nodes_at{};
+    for (auto& level : levels) {
+        level = dist(urbg);
+        n_nodes_at[level]++;
+    }
+
+    // The purely local region is filled in the order of priority, i.e., higher level first, and larger key first in the same level.
+    // Since the nodes of each level are streamed in ascending order of the keys, only the numbers of the nodes are needed here.
+    std::vector<std::tuple<NodePtr, LinkPtr>> local_nodes;
+    std::array<size_t, NLevels> n_local_nodes_at{}, local_nodes_offset{};
+    [&] {
+        auto local = NodeAllocTraits::get_suballocator(node_alloc, purely_local);
+        for (size_t level = NLevels; level-- != 0;) {
+            local_nodes_offset[level] = local_nodes.size();
+            for (size_t i = 0; i != n_nodes_at[level]; i++) {
+                auto allocated = NodeSuballocTraits::batch_allocate(local, single<Node>(), dynamic<Link>(level + 1));
+                if (!allocated) {
+                    return;
+                }
+                local_nodes.push_back(std::move(*allocated));
+                n_local_nodes_at[level]++;
             }
         }
-        node = node->links[0].prev;
+    }();
+
+    // the other nodes are co-allocated with their links, and packed into pages in key order
+    auto block = NodeAllocTraits::get_suballocator(node_alloc, new_per_page);
+    std::array<size_t, NLevels> n_visited_at{};
+    std::array<NodePtr, NLevels> last_at;
+    std::ranges::fill(last_at, header);
+
+    auto iter = std::ranges::begin(sorted);
+    for (const auto level : levels) {
+        const auto idx_in_level = n_visited_at[level]++;
+        const auto [node, links] = [&]() -> std::tuple<NodePtr, LinkPtr> {
+            if (const auto n_far_nodes = n_nodes_at[level] - n_local_nodes_at[level]; idx_in_level >= n_far_nodes) {
+                return local_nodes[local_nodes_offset[level] + (n_nodes_at[level] - 1 - idx_in_level)];
+            }
+
+            return PageAwarePlacement::place<NodeAllocTraits>(node_alloc, block, SingleObject<Node>{}, ObjectArray<Link>{size_t{level} + 1});
+        }();
+
+        new (&(*node)) Node{node_alloc, links, level, *iter};
+        ++iter;
+        for (level_type i = 0; i <= level; i++) {
+            new (&links[i]) Link{last_at[i], header};
+            last_at[i]->links[i].next = node;
+            last_at[i] = node;
+        }
+    }
+    for (size_t i = 0; i != NLevels; i++) {
+        header->links[i].prev = last_at[i];
     }
+
+    if (!local_nodes.empty()) {
+        last_local_node = std::get<0>(local_nodes.back());
+    }
+    size_cnt = n;
 }
 
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
 template <size_t PageAlign>
-std::array<size_t, 3> SkiplistMap<Key, T, Compare, Allocator, URBG>::analyze_edges()
+std::array<size_t, 3> SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::analyze_edges()
 {
     std::array<size_t, 3> res{};
 
@@ -721,39 +1170,76 @@ std::array<size_t, 3> SkiplistMap<Key, T, Compare, Allocator, URBG>::analyze_edg
     return res;
 }
 
-template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG>
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+template <size_t PageAlign>
+std::array<size_t, 3> SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::analyze_locality_in_traversal(size_t cache_size, PageReplacement policy)
+{
+    PageCacheSimulator cache{cache_size, policy};
+    return analyze_locality_in_traversal<PageAlign>(cache);
+}
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
 template <size_t PageAlign>
-std::array<size_t, 3> SkiplistMap<Key, T, Compare, Allocator, URBG>::analyze_locality_in_traversal(size_t cache_size)
+std::array<size_t, 3> SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::analyze_locality_in_traversal(PageCacheSimulator& cache)
 {
     std::array<size_t, 3> res{};
-    auto cached_pages = std::make_unique<uintptr_t[]>(cache_size);
-    std::fill_n(&cached_pages[0], cache_size, reinterpret_cast<uintptr_t>(nullptr) / PageAlign);
-    size_t lr_cache_idx = 0;
-
     auto local = NodeAllocTraits::get_suballocator(node_alloc, purely_local);
 
     for (NodePtr node = header->links[0].next; node != header; node = node->links[0].next) {
         const bool is_node_local = NodeAllocTraits::if_suballocator_contains(node_alloc, local, node);
         const auto page_id = reinterpret_cast<uintptr_t>(&(*node)) / PageAlign;
-        const auto cache_end = &cached_pages[cache_size];
 
         if (is_node_local) {
             res[0]++;
         } else {
-            const bool is_cache_hit = (std::find(&cached_pages[0], cache_end, page_id) != cache_end);
-            res[is_cache_hit ? 1 : 2]++;
-
-            if (!is_cache_hit) {
-                cached_pages[lr_cache_idx] = page_id;
-                lr_cache_idx++;
-                if (lr_cache_idx == cache_size) {
-                    lr_cache_idx = 0;
-                }
-            }
+            res[cache.access(page_id) ? 1 : 2]++;
         }
     }
 
     return res;
 }
 
+template <class Key, class T, class Compare, class Allocator, std::uniform_random_bit_generator URBG, bool Concurrent>
+template <class Visit>
+void SkiplistMap<Key, T, Compare, Allocator, URBG, Concurrent>::visit_query(const key_type& key, const size_t n_increments, Visit&& visit)
+{
+    auto local = NodeAllocTraits::get_suballocator(node_alloc, purely_local);
+    const auto visit_node = [&](const NodePtr& node) {
+        visit(static_cast<const void*>(&(*node)), NodeAllocTraits::if_suballocator_contains(node_alloc, local, node));
+    };
+
+    // the search of `lower_bound_impl()`
+    visit_node(header);
+    NodePtr lower_bound = header, prev_in_upper_level = header;
+    level_type level = lower_bound->level();
+    do {
+        for (;;) {
+            NodePtr prev = lower_bound->links[level].prev;
+            if (prev == prev_in_upper_level) {
+                break;
+            }
+
+            visit_node(prev);
+            if (comp(prev->value.get()->first, key)) {
+                prev_in_upper_level = std::move(prev);
+                break;
+            }
+
+            lower_bound = std::move(prev);
+        }
+    } while (level-- != 0);
+
+    if (lower_bound == header || comp(key, lower_bound->value.get()->first)) {
+        // not found
+        return;
+    }
+    NodePtr node = std::move(lower_bound);
+    for (size_t i = 0; i != n_increments; i++) {
+        node = node->links[0].next;
+        if (node == header) {
+            break;
+        }
+        visit_node(node);
+    }
+}
+
 }  // namespace FarMemoryContainer::Blocked
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace FarMemoryContainer
+{
+
+//! Epoch-based reclamation of the objects unlinked from a concurrent container.
+//! A reader pins the current epoch while it may hold pointers into the container.
+//! A retired object is reclaimed once every reader pinning an epoch at or before its retirement has left.
+class EpochManager
+{
+public:
+    //! the maximum number of the readers at the same time; more readers wait in `pin()`
+    static constexpr size_t MaxReaders = 256;
+    //! the number of the retired objects accumulated before `collect()` actually scans the readers
+    static constexpr size_t CollectionThreshold = 64;
+
+    class Guard
+    {
+        EpochManager* manager = nullptr;
+        size_t slot_idx = 0;
+
+        friend class EpochManager;
+        Guard(EpochManager* manager, size_t slot_idx) noexcept : manager(manager), slot_idx(slot_idx) {}
+
+    public:
+        Guard(Guard&& other) noexcept : manager(std::exchange(other.manager, nullptr)), slot_idx(other.slot_idx) {}
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        Guard& operator=(Guard&&) = delete;
+        ~Guard()
+        {
+            if (manager != nullptr) {
+                manager->unpin(slot_idx);
+            }
+        }
+    };
+
+    EpochManager() = default;
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+    ~EpochManager() { reclaim_all(); }
+
+    [[nodiscard]] inline Guard pin() noexcept;
+
+    //! `reclaimer` is called once no reader can refer to the object any longer
+    //! The object must have been unlinked from the container before.
+    inline void retire(std::function<void()> reclaimer);
+    //! reclaims the retired objects that no reader can refer to, if enough of them are accumulated
+    inline void collect();
+    //! waits until every reader pinning an epoch before the call leaves, and reclaims the objects retired before the call
+    //! The readers must not wait for the caller while they pin an epoch.
+    inline void synchronize();
+    //! reclaims all the retired objects, provided that there is no reader
+    inline void reclaim_all();
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<bool> in_use{false};
+        std::atomic<uint64_t> epoch{0};  // 0 while not pinned
+    };
+
+    std::atomic<uint64_t> global_epoch{1};
+    std::array<Slot, MaxReaders> slots;
+
+    std::mutex retired_mutex;
+    std::vector<std::pair<uint64_t, std::function<void()>>> retired;  // (epoch of retirement, reclaimer)
+
+    inline void unpin(size_t slot_idx) noexcept;
+};
+
+
+EpochManager::Guard EpochManager::pin() noexcept
+{
+    static thread_local size_t hint = std::hash<std::thread::id>{}(std::this_thread::get_id());
+
+    for (size_t i = hint;; i++) {
+        auto& slot = slots[i % MaxReaders];
+        bool expected = false;
+        if (slot.in_use.load(std::memory_order_relaxed) || !slot.in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            continue;
+        }
+        hint = i % MaxReaders;
+
+        // The epoch is published before the reader touches the container,
+        // and re-read so that a concurrent `collect()` either sees the slot or advances the epoch the reader pins.
+        uint64_t epoch = global_epoch.load();
+        for (;;) {
+            slot.epoch.store(epoch);
+            const auto current = global_epoch.load();
+            if (current == epoch) {
+                break;
+            }
+            epoch = current;
+        }
+        return Guard{this, hint};
+    }
+}
+void EpochManager::unpin(size_t slot_idx) noexcept
+{
+    slots[slot_idx].epoch.store(0, std::memory_order_release);
+    slots[slot_idx].in_use.store(false, std::memory_order_release);
+}
+
+void EpochManager::retire(std::function<void()> reclaimer)
+{
+    std::lock_guard lock{retired_mutex};
+    retired.emplace_back(global_epoch.fetch_add(1), std::move(reclaimer));
+}
+void EpochManager::collect()
+{
+    std::vector<std::function<void()>> reclaimable;
+    {
+        std::lock_guard lock{retired_mutex};
+        if (retired.size() < CollectionThreshold) {
+            return;
+        }
+
+        uint64_t min_pinned = std::numeric_limits<uint64_t>::max();
+        for (const auto& slot : slots) {
+            if (const auto epoch = slot.epoch.load(); epoch != 0) {
+                min_pinned = std::min(min_pinned, epoch);
+            }
+        }
+
+        // the entries retired before the oldest epoch pinned, which `partition` moves behind the ones still referred to
+        const auto to_reclaim = std::ranges::partition(retired, [min_pinned](const auto& entry) { return entry.first >= min_pinned; });
+        for (auto& entry : to_reclaim) {
+            reclaimable.push_back(std::move(entry.second));
+        }
+        retired.erase(to_reclaim.begin(), to_reclaim.end());
+    }
+    for (auto& reclaimer : reclaimable) {
+        reclaimer();
+    }
+}
+void EpochManager::synchronize()
+{
+    const auto epoch = global_epoch.fetch_add(1) + 1;
+    for (const auto& slot : slots) {
+        for (auto pinned = slot.epoch.load(); pinned != 0 && pinned < epoch; pinned = slot.epoch.load()) {
+            std::this_thread::yield();
+        }
+    }
+
+    std::vector<std::function<void()>> reclaimable;
+    {
+        std::lock_guard lock{retired_mutex};
+        // the entries retired before `epoch`, which `partition` moves behind the ones still referred to
+        const auto to_reclaim = std::ranges::partition(retired, [epoch](const auto& entry) { return entry.first >= epoch; });
+        for (auto& entry : to_reclaim) {
+            reclaimable.push_back(std::move(entry.second));
+        }
+        retired.erase(to_reclaim.begin(), to_reclaim.end());
+    }
+    for (auto& reclaimer : reclaimable) {
+        reclaimer();
+    }
+}
+void EpochManager::reclaim_all()
+{
+    std::lock_guard lock{retired_mutex};
+    for (auto& entry : retired) {
+        entry.second();
+    }
+    retired.clear();
+}
+
+}  // namespace FarMemoryContainer
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+
+namespace FarMemoryContainer
+{
+
+//! the number of the lookups in flight at a time in `multi_find()` of the containers
+constexpr size_t InterleavedLookupWidth = 16;
+
+//! a hint for the far-memory store which does nothing, given to `multi_find()` by default
+struct NoPrefetch {
+    void operator()(const void*, size_t) const noexcept {}
+};
+
+//! runs `n` lookups interleaved, in the manner of asynchronous memory access chaining (AMAC)
+//! Each lookup is a state machine suspended whenever it is going to access a node it has just hinted,
+//! and the other lookups are advanced meanwhile, so that the misses of the lookups overlap.
+//! @param start `start(state, i)` begins the i-th lookup in `state`
+//! @param step `step(state)` advances the lookup in `state` by a node
+//! Both return whether the lookup has not finished.
+template <class State, size_t Width = InterleavedLookupWidth, class Start, class Step>
+void interleave_lookups(const size_t n, Start&& start, Step&& step)
+{
+    std::array<State, Width> states{};
+    size_t n_started = 0, n_active = 0;
+    // the lookups finishing at the start do not take a slot
+    const auto start_next = [&](State& state) {
+        while (n_started != n) {
+            if (start(state, n_started++)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    while (n_active != Width && start_next(states[n_active])) {
+        n_active++;
+    }
+    while (n_active != 0) {
+        for (size_t i = 0; i < n_active;) {
+            if (step(states[i]) || start_next(states[i])) {
+                i++;
+            } else if (--n_active != i) {
+                // The last one takes the slot, and is advanced in this round yet.
+                states[i] = std::move(states[n_active]);
+            }
+        }
+    }
+}
+
+}  // namespace FarMemoryContainer
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+namespace FarMemoryContainer
+{
+
+//! whether `upper_bound_in_keys` compares the keys by SIMD instructions
+template <class Key, class Compare>
+constexpr bool IsSimdSearchable = std::integral<Key> && (sizeof(Key) == 4 || sizeof(Key) == 8)
+                                  && (std::is_same_v<Compare, std::less<Key>> || std::is_same_v<Compare, std::less<>>);
+
+//! the number of the keys compared by an instruction
+template <class Key>
+constexpr size_t KeySearchLanes =
+#if defined(__AVX512F__)
+    64 / sizeof(Key);
+#elif defined(__AVX2__)
+    32 / sizeof(Key);
+#else
+    1;
+#endif
+
+//! keys of the elements in a node, stored contiguously apart from the values
+//! The capacity is rounded up to a multiple of `KeySearchLanes`, so that the search loads whole vectors.
+template <class Key, size_t MaxNElems>
+struct KeyArray {
+    static constexpr size_t Capacity = (MaxNElems + KeySearchLanes<Key> - 1) / KeySearchLanes<Key> * KeySearchLanes<Key>;
+    std::array<Key, Capacity> keys{};
+};
+
+//! stand-in for `KeyArray` in the nodes that search the elements themselves
+struct NoKeyArray {
+};
+
+//! @return the index of the first key greater than `key` in the sorted `keys[0, n)`
+//! If `Key` is a 32-bit or 64-bit integer compared by `std::less` and `Capacity` is a multiple of `KeySearchLanes<Key>`,
+//! the keys are compared by AVX-512 or AVX2 if available. Otherwise, it is a branchless binary search.
+template <class Key, size_t Capacity, class K, class Compare>
+inline size_t upper_bound_in_keys(const std::array<Key, Capacity>& keys, const size_t n, const K& key, const Compare& comp)
+{
+#if defined(__AVX512F__) || defined(__AVX2__)
+    if constexpr (IsSimdSearchable<Key, Compare> && std::is_same_v<K, Key> && Capacity % KeySearchLanes<Key> == 0) {
+        constexpr size_t Lanes = KeySearchLanes<Key>;
+
+        for (size_t base = 0; base < n; base += Lanes) {
+            const auto* chunk = &keys[base];
+#if defined(__AVX512F__)
+            const __m512i vec = _mm512_loadu_si512(chunk);
+            uint64_t greater;
+            if constexpr (sizeof(Key) == 8 && std::is_unsigned_v<Key>) {
+                greater = _mm512_cmpgt_epu64_mask(vec, _mm512_set1_epi64(static_cast<int64_t>(key)));
+            } else if constexpr (sizeof(Key) == 8) {
+                greater = _mm512_cmpgt_epi64_mask(vec, _mm512_set1_epi64(static_cast<int64_t>(key)));
+            } else if constexpr (std::is_unsigned_v<Key>) {
+                greater = _mm512_cmpgt_epu32_mask(vec, _mm512_set1_epi32(static_cast<int32_t>(key)));
+            } else {
+                greater = _mm512_cmpgt_epi32_mask(vec, _mm512_set1_epi32(static_cast<int32_t>(key)));
+            }
+#else
+            const __m256i vec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chunk));
+            uint64_t greater;
+            if constexpr (sizeof(Key) == 8) {
+                // AVX2 only compares signed integers, so the unsigned ones are offset by flipping the sign bits.
+                const __m256i offset = _mm256_set1_epi64x(std::is_unsigned_v<Key> ? INT64_MIN : 0);
+                const __m256i cmp = _mm256_cmpgt_epi64(_mm256_xor_si256(vec, offset),
+                    _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(key)), offset));
+                greater = static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(cmp)));
+            } else {
+                const __m256i offset = _mm256_set1_epi32(std::is_unsigned_v<Key> ? INT32_MIN : 0);
+                const __m256i cmp = _mm256_cmpgt_epi32(_mm256_xor_si256(vec, offset),
+                    _mm256_xor_si256(_mm256_set1_epi32(static_cast<int32_t>(key)), offset));
+                greater = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(cmp)));
+            }
+#endif
+            // the lanes beyond `n` hold stale keys
+            if (n - base < Lanes) {
+                greater |= uint64_t{1} << (n - base);
+            }
+            if (greater != 0) {
+                return base + std::countr_zero(greater);
+            }
+        }
+        return n;
+    }
+#endif
+
+    if (n == 0) {
+        return 0;
+    }
+    const auto num_comp = std::bit_width(n);
+    const size_t first_idx = n - (size_t(1) << (num_comp - 1));
+    size_t pos = (comp(key, keys[first_idx]) ? 0 : first_idx + 1);
+
+    for (size_t i = num_comp - 1; i != 0; i--) {
+        const size_t step = size_t(1) << (i - 1);
+        pos = (comp(key, keys[pos + step - 1]) ? pos : pos + step);
+    }
+
+    return pos;
+}
+
+}  // namespace FarMemoryContainer
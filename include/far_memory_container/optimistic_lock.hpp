@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+
+namespace FarMemoryContainer
+{
+
+//! Version counter of a node for optimistic lock coupling.
+//! A reader takes a snapshot of the version before reading the node, and validates it afterward;
+//! a writer makes the version odd while it modifies the node.
+//! The writers must be serialized by another lock, so the latch itself never waits for another writer.
+struct OptimisticVersion {
+    std::atomic<uint64_t> version{0};
+
+    //! @return std::nullopt if a writer is modifying the node (or has made it obsolete)
+    std::optional<uint64_t> read_begin() const noexcept
+    {
+        const auto v = version.load(std::memory_order_acquire);
+        if (v % 2 != 0) {
+            return std::nullopt;
+        }
+        return v;
+    }
+    //! @return whether the node has not been modified since `read_begin()` returned `v`
+    bool read_validate(uint64_t v) const noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return version.load(std::memory_order_relaxed) == v;
+    }
+
+    bool is_latched() const noexcept { return version.load(std::memory_order_relaxed) % 2 != 0; }
+    void latch() noexcept
+    {
+        version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    void unlatch() noexcept
+    {
+        version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
+
+//! stand-in for `OptimisticVersion` in the containers without concurrency control
+struct NoVersion {
+};
+
+}  // namespace FarMemoryContainer
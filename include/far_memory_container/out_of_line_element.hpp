@@ -0,0 +1,62 @@
+#pragma once
+
+#include <farmalloc/collective_allocator_traits.hpp>
+
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+namespace FarMemoryContainer
+{
+using namespace FarMalloc;
+
+//! the counterpart of `AlignedBuffer` for a key-value pair, which holds the pair out of line and a copy of its key
+//! The pair is allocated in the swappable region, so that the node holding the buffer fits more elements in the purely local region.
+//! Moving the buffer moves only the pointer, and the pair stays where it is.
+template <class PtrToVal>
+struct OutOfLineElement {
+    using value_type = typename std::pointer_traits<PtrToVal>::element_type;
+    using key_type = std::remove_const_t<typename value_type::first_type>;
+
+    // searched instead of the pair, so that a search doesn't touch the swappable region
+    key_type key;
+    PtrToVal ptr;
+    constexpr OutOfLineElement() {}  // default initialization
+
+    template <class Alloc, class... Args>
+    void construct(Alloc& allocator, Args&&... args)
+    {
+        using Traits = typename collective_allocator_traits<Alloc>::template rebind_traits<value_type>;
+        typename Traits::allocator_type value_alloc{allocator};
+        auto suballoc = Traits::get_suballocator(value_alloc, swappable_plain);
+        auto allocated = Traits::suballocator_traits::batch_allocate(suballoc, request::single<value_type>());
+        if (!allocated) {
+            throw std::bad_alloc{};
+        }
+        ptr = std::move(std::get<0>(*allocated));
+        Traits::construct(value_alloc, get(), std::forward<Args>(args)...);
+        key = get()->first;
+    }
+    template <class Alloc>
+    void destroy(Alloc& allocator)
+    {
+        using Traits = typename collective_allocator_traits<Alloc>::template rebind_traits<value_type>;
+        typename Traits::allocator_type value_alloc{allocator};
+        Traits::destroy(value_alloc, get());
+        Traits::deallocate(value_alloc, std::move(ptr), 1);
+    }
+    template <class Alloc>
+    void move_from(Alloc&, OutOfLineElement& other)
+    {
+        key = std::move(other.key);
+        ptr = std::move(other.ptr);
+    }
+
+    value_type* get() noexcept { return std::to_address(ptr); }
+    const value_type* get() const noexcept { return std::to_address(ptr); }
+};
+
+}  // namespace FarMemoryContainer
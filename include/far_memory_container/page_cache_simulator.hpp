@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+
+namespace FarMemoryContainer
+{
+
+//! the replacement policies of `PageCacheSimulator`
+enum class PageReplacement {
+    //! evicts the page cached first, regardless of the hits, as UMap does
+    FIFO,
+    LRU,
+    //! the second-chance approximation of LRU
+    CLOCK
+};
+
+//! simulates a page cache of `capacity` pages, e.g., the buffer of UMap, in O(1) time per access
+//! The pages are identified by the addresses divided by the page size, and the cache is empty at first.
+class PageCacheSimulator
+{
+public:
+    PageCacheSimulator(size_t capacity, PageReplacement policy)
+        : capacity(capacity), policy(policy)
+    {
+        frames.reserve(capacity);
+        index.reserve(capacity);
+    }
+
+    //! @return whether `page_id` was cached, i.e., a cache hit; it is cached afterwards in either case
+    bool access(uintptr_t page_id)
+    {
+        if (const auto iter = index.find(page_id); iter != index.end()) {
+            n_hits_++;
+            if (policy == PageReplacement::LRU) {
+                unlink(iter->second);
+                link_front(iter->second);
+            } else if (policy == PageReplacement::CLOCK) {
+                frames[iter->second].referenced = true;
+            }
+            return true;
+        }
+
+        n_misses_++;
+        if (capacity == 0) {
+            return false;
+        }
+        if (frames.size() != capacity) {
+            // The frames are filled in the order of the misses, which the ring of FIFO and CLOCK follows.
+            frames.push_back(Frame{.page_id = page_id});
+            index.emplace(page_id, frames.size() - 1);
+            if (policy == PageReplacement::LRU) {
+                link_front(frames.size() - 1);
+            }
+            return false;
+        }
+
+        const size_t victim = [&] {
+            switch (policy) {
+            case PageReplacement::LRU: {
+                const size_t res = lru_tail;
+                unlink(res);
+                return res;
+            }
+            case PageReplacement::CLOCK:
+                while (frames[hand].referenced) {
+                    frames[hand].referenced = false;
+                    advance_hand();
+                }
+                [[fallthrough]];
+            case PageReplacement::FIFO:
+            default: {
+                const size_t res = hand;
+                advance_hand();
+                return res;
+            }
+            }
+        }();
+        n_evictions_++;
+        index.erase(frames[victim].page_id);
+        frames[victim].page_id = page_id;
+        frames[victim].referenced = false;
+        index.emplace(page_id, victim);
+        if (policy == PageReplacement::LRU) {
+            link_front(victim);
+        }
+        return false;
+    }
+
+    size_t n_hits() const noexcept { return n_hits_; }
+    size_t n_misses() const noexcept { return n_misses_; }
+    //! the number of the misses which evicted a page, i.e., the swap-outs of a full cache
+    size_t n_evictions() const noexcept { return n_evictions_; }
+
+private:
+    static constexpr size_t Null = std::numeric_limits<size_t>::max();
+
+    struct Frame {
+        uintptr_t page_id;
+        //! the neighbors in the recency list of LRU, the most recently used first
+        size_t prev = Null, next = Null;
+        //! the reference bit of CLOCK
+        bool referenced = false;
+    };
+
+    void link_front(size_t idx)
+    {
+        frames[idx].prev = Null;
+        frames[idx].next = lru_head;
+        if (lru_head != Null) {
+            frames[lru_head].prev = idx;
+        } else {
+            lru_tail = idx;
+        }
+        lru_head = idx;
+    }
+    void unlink(size_t idx)
+    {
+        auto& frame = frames[idx];
+        (frame.prev != Null ? frames[frame.prev].next : lru_head) = frame.next;
+        (frame.next != Null ? frames[frame.next].prev : lru_tail) = frame.prev;
+    }
+    void advance_hand()
+    {
+        hand++;
+        if (hand == capacity) {
+            hand = 0;
+        }
+    }
+
+    size_t capacity;
+    PageReplacement policy;
+    std::vector<Frame> frames;
+    //! page id -> the index of its frame
+    std::unordered_map<uintptr_t, size_t> index;
+    //! the next victim of FIFO and CLOCK
+    size_t hand = 0;
+    size_t lru_head = Null, lru_tail = Null;
+
+    size_t n_hits_ = 0, n_misses_ = 0, n_evictions_ = 0;
+};
+
+}  // namespace FarMemoryContainer
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <far_memory_container/page_aware/b_tree.hpp>
+#include <far_memory_container/placed/b_tree.hpp>
 
 #include <algorithm>
 #include <bit>
@@ -8,23 +8,24 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
-#include <set>  // for analyze_locality_in_traversal
+#include <ranges>
 #include <utility>
+#include <vector>
 
 
-namespace FarMemoryContainer::PageAware
+namespace FarMemoryContainer::Placed
 {
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-BTreeMap<Key, T, MaxNElems, Compare, Allocator>::~BTreeMap() noexcept
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::~BTreeMap() noexcept
 {
     clear();
 
     header->~Node();
     AllocTraits::deallocate(alloc, std::move(header), 1);
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::clear()
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::clear()
 {
     if (header->children[0] != nullptr) {
         clear_step(header->children[0]);
@@ -36,8 +37,8 @@ void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::clear()
     size_cnt = 0;
     begin_node = header;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::clear_step(NodePtr node)
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::clear_step(NodePtr node)
 {
     if (/* inner node */ node->children[0] != nullptr) {
         for (size_t i = 0; i <= node->n_elems; i++) {
@@ -51,11 +52,20 @@ void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::clear_step(NodePtr node)
     node->~Node();
     AllocTraits::deallocate(alloc, std::move(node), 1);
 }
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+size_t BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::height() const noexcept
+{
+    size_t height = 0;
+    for (NodePtr node = header->children[0]; node != nullptr; node = node->children[0]) {
+        height++;
+    }
+    return height;
+}
 
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
 template <class K>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::find_impl(const K& x) const -> iterator
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::find_impl(const K& x) const -> iterator
 {
     for (NodePtr node = header->children[0]; node != nullptr;) {
         const auto upper_bound = node->upper_bound(x, comp);
@@ -69,13 +79,12 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::find_impl(const K& x) cons
 }
 
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert(value_type&& x) -> std::pair<iterator, bool>
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::insert(value_type&& x) -> std::pair<iterator, bool>
 {
-    auto suballoc = AllocTraits::get_suballocator(alloc, header);
     NodePtr root = header->children[0];
     if (/* first element */ root == nullptr) {
-        auto root = SuballocTraits::allocate(suballoc, 1);
+        auto [root] = Placement::template allocate<AllocTraits>(alloc, header, SingleObject<Node>{});
         new (&(*root)) Node{.n_elems = 1, .children = {}, .parent = header};
         root->elems[0].construct(alloc, std::move(x));
 
@@ -85,9 +94,9 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert(value_type&& x) ->
         return {{{.node = std::move(root), .elem_idx = 0}}, true};
     }
 
-    auto res = insert_step(std::move(x), root, AllocTraits::get_suballocator(alloc, header));
+    auto res = insert_step(std::move(x), root);
     if (res.new_child != nullptr) {
-        auto new_node = SuballocTraits::allocate(suballoc, 1);
+        auto [new_node] = Placement::template allocate<AllocTraits>(alloc, header, SingleObject<Node>{});
 
         new (&(*new_node)) Node{.n_elems = 1, .children = {root, res.new_child}, .parent = header};
         header->children[0] = root->parent = res.new_child->parent = new_node;
@@ -101,23 +110,21 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert(value_type&& x) ->
     return res.result;
 }
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert_step(value_type&& x, NodePtr node, Suballoc suballoc) -> InsertStepResult
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::insert_step(value_type&& x, NodePtr node) -> InsertStepResult
 {
     const auto upper_bound = node->upper_bound(x.first, comp);
     if (/* already exists */ upper_bound != 0 && !comp(node->elems[upper_bound - 1].get()->first, x.first)) {
         return {.result = {{{.node = std::move(node), .elem_idx = upper_bound - 1}}, false}};
     }
 
-    auto node_suballoc = AllocTraits::get_suballocator(alloc, node);
-
     bool to_insert;
     InsertStepResult res = (/* leaf node */ node->children[upper_bound] == nullptr
         ? to_insert = true,
         size_cnt++,
         InsertStepResult{.result = {{{.node = nullptr}}, true}, .new_child = nullptr}
         : [&] {
-              auto res = insert_step(std::move(x), node->children[upper_bound], std::move(node_suballoc));
+              auto res = insert_step(std::move(x), node->children[upper_bound]);
               to_insert = (res.new_child != nullptr);
               return res;
           }());
@@ -143,15 +150,8 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert_step(value_type&& x
         return res;
     }
 
-    auto allocated = SuballocTraits::batch_allocate(suballoc, request::single<Node>());
-    if (!allocated) {
-        suballoc = AllocTraits::get_suballocator(alloc, swappable_plain);
-        allocated = SuballocTraits::batch_allocate(suballoc, request::single<Node>());
-    }
-    if (!allocated) {
-        throw std::bad_alloc{};
-    }
-    auto& [new_node] = *allocated;
+    // the new sibling is placed near the parent
+    auto [new_node] = Placement::template allocate<AllocTraits>(alloc, node->parent, SingleObject<Node>{});
 
     new (&(*new_node)) Node{.n_elems = MaxNElems / 2, .children = {}, .parent = node->parent};
     node->n_elems = (MaxNElems + 1) / 2;
@@ -202,7 +202,7 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert_step(value_type&& x
             node->children[i] = nullptr;
         }
         if (res.result.first.node == nullptr) {
-            res.result.first = {{.node = new_node, .elem_idx = upper_bound - node->n_elems}};
+            res.result.first = {{.node = new_node, .elem_idx = upper_bound - node->n_elems - 1}};
         }
         res.pushed_up.emplace(std::move(*node->elems[node->n_elems].get()));
         node->elems[node->n_elems].destroy(alloc);
@@ -218,8 +218,8 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::insert_step(value_type&& x
     return res;
 }
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::erase(const key_type& key) -> size_type
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::erase(const key_type& key) -> size_type
 {
     NodePtr root = header->children[0];
     if (root == nullptr) {
@@ -231,6 +231,9 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::erase(const key_type& key)
         header->children[0] = std::move(root->children[0]);
         if (header->children[0] != nullptr) {
             header->children[0]->parent = header;
+        } else {
+            // the last element has been erased
+            begin_node = header;
         }
 
         root->~Node();
@@ -239,8 +242,8 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::erase(const key_type& key)
 
     return result;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::erase_step(const key_type& key, NodePtr node, AlignedBuffer<value_type>* successor) -> EraseStepResult
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::erase_step(const key_type& key, NodePtr node, AlignedBuffer<value_type>* successor) -> EraseStepResult
 {
     const auto upper_bound = node->upper_bound(key, comp);
     if (/* already exists */ upper_bound != 0 && !comp(node->elems[upper_bound - 1].get()->first, key)) {
@@ -263,8 +266,8 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::erase_step(const key_type&
     }
     return res;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::swap_predecessor(AlignedBuffer<value_type>& target, NodePtr node, AlignedBuffer<value_type>* successor) -> AlignedBuffer<value_type>*
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::swap_predecessor(AlignedBuffer<value_type>& target, NodePtr node, AlignedBuffer<value_type>* successor) -> AlignedBuffer<value_type>*
 {
     if (/* leaf node */ node->children[node->n_elems] == nullptr) {
         target.move_from(alloc, node->elems[node->n_elems - 1]);
@@ -273,8 +276,8 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::swap_predecessor(AlignedBu
     const auto* pulled_down = swap_predecessor(target, node->children[node->n_elems], &node->elems[node->n_elems]);
     return (pulled_down == nullptr ? nullptr : fill_hole(pulled_down - &node->elems[0], node, successor));
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::fill_hole(const size_t idx_hole, NodePtr node, AlignedBuffer<value_type>* successor) -> AlignedBuffer<value_type>*
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::fill_hole(const size_t idx_hole, NodePtr node, AlignedBuffer<value_type>* successor) -> AlignedBuffer<value_type>*
 {
     for (size_t i = idx_hole + 1; i != node->n_elems; i++) {
         node->elems[i - 1].move_from(alloc, node->elems[i]);
@@ -354,21 +357,21 @@ auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::fill_hole(const size_t idx
     return successor;
 }
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::relocate(NodePtr& node, Suballoc suballoc)
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::relocate(NodePtr& node, Block& block)
 {
     const bool relocating_begin_node = (node == begin_node);
     const auto child_iter_to_node = std::ranges::find(node->parent->children, node);
 
-    if (AllocTraits::relocate(
-            alloc, suballoc, [this](Node* from, auto, Node* to) {
+    if (Placement::template relocate<AllocTraits>(
+            alloc, block, [this](Node* from, auto, Node* to) {
                 new (to) Node{.n_elems = from->n_elems, .children = from->children, .parent = from->parent};
                 for (size_t i = 0; i != to->n_elems; i++) {
                     to->elems[i].move_from(alloc, from->elems[i]);
                 }
                 from->~Node();
             },
-            std::tie(node), request::single<Node>())) {
+            std::tie(node), SingleObject<Node>{})) {
 
         if (child_iter_to_node != node->parent->children.end()) {
             *child_iter_to_node = node;
@@ -385,17 +388,17 @@ void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::relocate(NodePtr& node, Su
 }
 
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::batch_block()
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::batch_block()
 {
     if (size_cnt == 0) {
         return;
     }
-    auto block = AllocTraits::get_suballocator(alloc, new_per_page);
+    auto block = Placement::template new_block<AllocTraits>(alloc, header);
     batch_block_step(header->children[0], block);
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::batch_block_step(NodePtr node, Suballoc& block)
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::batch_block_step(NodePtr node, Block& block)
 {
     if (/* inner node */ node->children[0] != nullptr) {
         for (size_t i = 0; i <= node->n_elems; i++) {
@@ -403,17 +406,13 @@ void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::batch_block_step(NodePtr n
         }
     }
 
-    if (auto local = AllocTraits::get_suballocator(alloc, purely_local);
-        !AllocTraits::if_suballocator_contains(alloc, local, node)) {
-        if (!SuballocTraits::is_occupancy_under(block, 0.7)) {
-            block = AllocTraits::get_suballocator(alloc, new_per_page);
-        }
+    if (!Placement::template is_local<AllocTraits>(alloc, node)) {
         relocate(node, block);
     }
 }
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::batch_vEB()
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::batch_vEB()
 {
     if (size_cnt == 0) {
         return;
@@ -424,21 +423,17 @@ void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::batch_vEB()
     for (auto node = root; node != nullptr; node = node->children[0]) {
         height++;
     }
-    auto block = AllocTraits::get_suballocator(alloc, new_per_page);
+    auto block = Placement::template new_block<AllocTraits>(alloc, header);
     batch_vEB_step(root, height, block);
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::batch_vEB_step(NodePtr& node, size_t height, Suballoc& block)
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::batch_vEB_step(NodePtr& node, size_t height, Block& block)
 {
     switch (height) {
     case 0:
         return;
     case 1: {
-        if (auto local = AllocTraits::get_suballocator(alloc, purely_local);
-            !AllocTraits::if_suballocator_contains(alloc, local, node)) {
-            if (!SuballocTraits::is_occupancy_under(block, 0.7)) {
-                block = AllocTraits::get_suballocator(alloc, new_per_page);
-            }
+        if (!Placement::template is_local<AllocTraits>(alloc, node)) {
             relocate(node, block);
         }
     } break;
@@ -469,9 +464,144 @@ void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::batch_vEB_step(NodePtr& no
     }
 }
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+template <std::ranges::input_range R>
+    requires std::ranges::sized_range<R>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::bulk_load_block(R&& sorted)
+{
+    bulk_load(std::forward<R>(sorted), false);
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+template <std::ranges::input_range R>
+    requires std::ranges::sized_range<R>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::bulk_load_vEB(R&& sorted)
+{
+    bulk_load(std::forward<R>(sorted), true);
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+template <class R>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::bulk_load(R&& sorted, const bool is_vEB)
+{
+    clear();
+    const size_t n = std::ranges::size(sorted);
+    if (n == 0) {
+        return;
+    }
+
+    BulkLoadState state{.max_widths = {1}, .levels = {}, .block = Placement::template new_block<AllocTraits>(alloc, header)};
+    while (state.max_widths.back() < n + 1) {
+        state.max_widths.push_back(state.max_widths.back() * (MaxNElems + 1));
+    }
+    const size_t height = state.max_widths.size() - 1;
+    state.levels.resize(height);
+
+    // the nodes are allocated in the same order as `batch_block()` / `batch_vEB()`
+    if (is_vEB) {
+        bulk_load_vEB_step(n + 1, 0, height, state);
+    } else {
+        bulk_load_block_step(n + 1, 0, state);
+    }
+
+    // linking the nodes level by level
+    for (size_t depth = 0; depth + 1 != height; depth++) {
+        auto child = state.levels[depth + 1].begin();
+        for (auto& node : state.levels[depth]) {
+            for (size_t i = 0; i <= node->n_elems; i++, ++child) {
+                node->children[i] = *child;
+                (*child)->parent = node;
+            }
+        }
+    }
+    NodePtr root = state.levels.front().front();
+    root->parent = header;
+    header->children[0] = root;
+    begin_node = state.levels.back().front();
+
+    auto iter = std::ranges::begin(sorted);
+    bulk_load_fill(std::move(root), iter);
+    size_cnt = n;
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::bulk_load_n_children(const size_t width, const size_t depth, const BulkLoadState& state) const -> size_t
+{
+    const size_t height = state.max_widths.size() - 1 - depth;
+    if (/* leaf node */ height == 1) {
+        return 0;
+    }
+
+    // as few children as possible, among which the width is distributed evenly
+    const auto max_child_width = state.max_widths[height - 1];
+    return std::max((width + max_child_width - 1) / max_child_width, (depth == 0 ? size_t{2} : MinNElems + 1));
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::bulk_load_place(const size_t width, const size_t depth, BulkLoadState& state)
+{
+    auto [node] = Placement::template place<AllocTraits>(alloc, state.block, SingleObject<Node>{});
+
+    const auto n_children = bulk_load_n_children(width, depth, state);
+    new (&(*node)) Node{.n_elems = (n_children == 0 ? width - 1 : n_children - 1), .children = {}, .parent = nullptr};
+    state.levels[depth].push_back(std::move(node));
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::bulk_load_block_step(const size_t width, const size_t depth, BulkLoadState& state)
+{
+    const auto n_children = bulk_load_n_children(width, depth, state);
+    for (size_t i = 0; i != n_children; i++) {
+        bulk_load_block_step(width / n_children + (i < width % n_children ? 1 : 0), depth + 1, state);
+    }
+
+    bulk_load_place(width, depth, state);
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::bulk_load_vEB_step(const size_t width, const size_t depth, const size_t height, BulkLoadState& state)
+{
+    switch (height) {
+    case 0:
+        return;
+    case 1:
+        bulk_load_place(width, depth, state);
+        break;
+
+    default: {
+        const auto upper_height = (height + 1) / 2, lower_height = height - upper_height;
+        bulk_load_vEB_step(width, depth, upper_height, state);
+
+        std::vector<size_t> widths{width}, children_widths;
+        for (size_t down_cnt = 0; down_cnt != upper_height; down_cnt++) {
+            for (const auto w : widths) {
+                const auto n_children = bulk_load_n_children(w, depth + down_cnt, state);
+                for (size_t i = 0; i != n_children; i++) {
+                    children_widths.push_back(w / n_children + (i < w % n_children ? 1 : 0));
+                }
+            }
+            widths.swap(children_widths);
+            children_widths.clear();
+        }
+
+        for (const auto subtree_width : widths) {
+            bulk_load_vEB_step(subtree_width, depth + upper_height, lower_height, state);
+        }
+    } break;
+    }
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+template <class Iter>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::bulk_load_fill(NodePtr node, Iter& iter)
+{
+    for (size_t i = 0; i != node->n_elems; i++, ++iter) {
+        if (/* inner node */ node->children[0] != nullptr) {
+            bulk_load_fill(node->children[i], iter);
+        }
+        node->elems[i].construct(alloc, *iter);
+    }
+    if (/* inner node */ node->children[0] != nullptr) {
+        bulk_load_fill(node->children[node->n_elems], iter);
+    }
+}
+
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
 template <size_t PageAlign>
-std::array<size_t, 3> BTreeMap<Key, T, MaxNElems, Compare, Allocator>::analyze_edges()
+std::array<size_t, 3> BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::analyze_edges()
 {
     std::array<size_t, 3> res{};
     if (header->children[0] != nullptr) {
@@ -479,17 +609,16 @@ std::array<size_t, 3> BTreeMap<Key, T, MaxNElems, Compare, Allocator>::analyze_e
     }
     return res;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
 template <size_t PageAlign>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::analyze_edges_step(NodePtr node, std::array<size_t, 3>& acc)
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::analyze_edges_step(NodePtr node, std::array<size_t, 3>& acc)
 {
     if (/* inner node */ node->children[0] != nullptr) {
-        auto local = AllocTraits::get_suballocator(alloc, purely_local);
-        const bool is_node_local = AllocTraits::if_suballocator_contains(alloc, local, node);
+        const bool is_node_local = Placement::template is_local<AllocTraits>(alloc, node);
 
         for (size_t i = 0; i <= node->n_elems; i++) {
             NodePtr child = node->children[i];
-            const bool is_child_local = AllocTraits::if_suballocator_contains(alloc, local, child);
+            const bool is_child_local = Placement::template is_local<AllocTraits>(alloc, child);
             if (is_node_local && is_child_local) {
                 acc[0] += 1;
             } else {
@@ -501,52 +630,35 @@ void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::analyze_edges_step(NodePtr
     }
 }
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+template <size_t PageAlign>
+std::array<size_t, 3> BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::analyze_locality_in_traversal(size_t cache_size, PageReplacement policy)
+{
+    PageCacheSimulator cache{cache_size, policy};
+    return analyze_locality_in_traversal<PageAlign>(cache);
+}
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
 template <size_t PageAlign>
-std::array<size_t, 3> BTreeMap<Key, T, MaxNElems, Compare, Allocator>::analyze_locality_in_traversal(size_t cache_size)
+std::array<size_t, 3> BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::analyze_locality_in_traversal(PageCacheSimulator& cache)
 {
     std::array<size_t, 3> res{};
     if (header->children[0] != nullptr) {
-        auto cached_pages_ary = std::make_unique<uintptr_t[]>(cache_size);
-        std::fill_n(&cached_pages_ary[0], cache_size, reinterpret_cast<uintptr_t>(nullptr) / PageAlign);
-        size_t lr_cache_idx = 0;
-        std::set<uintptr_t> cached_pages_set;
-
-        analyze_locality_in_traversal_step<PageAlign>(header->children[0], cache_size, cached_pages_set, &cached_pages_ary[0], lr_cache_idx, res);
+        analyze_locality_in_traversal_step<PageAlign>(header->children[0], cache, res);
     }
     return res;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
 template <size_t PageAlign>
-void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::analyze_locality_in_traversal_step(NodePtr node, const size_t cache_size, std::set<uintptr_t>& cached_pages_set, uintptr_t* const cached_pages_ary, size_t& lr_cache_idx, std::array<size_t, 3>& cnt)
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::analyze_locality_in_traversal_step(NodePtr node, PageCacheSimulator& cache, std::array<size_t, 3>& cnt)
 {
-    auto local = AllocTraits::get_suballocator(alloc, purely_local);
-    const bool is_node_local = AllocTraits::if_suballocator_contains(alloc, local, node);
+    const bool is_node_local = Placement::template is_local<AllocTraits>(alloc, node);
 
     const auto page_id = reinterpret_cast<uintptr_t>(&(*node)) / PageAlign;
     const auto touch_this_node = [&] {
         if (is_node_local) {
             cnt[0]++;
         } else {
-            const bool is_cache_hit = cached_pages_set.contains(page_id);
-            cnt[is_cache_hit ? 1 : 2]++;
-
-            if (!is_cache_hit) {
-                const auto iter = cached_pages_set.find(cached_pages_ary[lr_cache_idx]);
-                if (iter != cached_pages_set.cend()) {
-                    auto node = cached_pages_set.extract(iter);
-                    node.value() = page_id;
-                    cached_pages_set.insert(std::move(node));
-                } else {
-                    cached_pages_set.insert(page_id);
-                }
-
-                cached_pages_ary[lr_cache_idx] = page_id;
-                lr_cache_idx++;
-                if (lr_cache_idx == cache_size) {
-                    lr_cache_idx = 0;
-                }
-            }
+            cnt[cache.access(page_id) ? 1 : 2]++;
         }
     };
 
@@ -555,11 +667,67 @@ void BTreeMap<Key, T, MaxNElems, Compare, Allocator>::analyze_locality_in_traver
         return;
     }
 
-    analyze_locality_in_traversal_step<PageAlign>(node->children[0], cache_size, cached_pages_set, cached_pages_ary, lr_cache_idx, cnt);
+    analyze_locality_in_traversal_step<PageAlign>(node->children[0], cache, cnt);
     for (size_t i = 1; i <= node->n_elems; i++) {
         touch_this_node();
-        analyze_locality_in_traversal_step<PageAlign>(node->children[i], cache_size, cached_pages_set, cached_pages_ary, lr_cache_idx, cnt);
+        analyze_locality_in_traversal_step<PageAlign>(node->children[i], cache, cnt);
+    }
+}
+
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+template <class Visit>
+void BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::visit_query(const key_type& x, const size_t n_increments, Visit&& visit)
+{
+    const auto visit_node = [&](const NodePtr& node) {
+        visit(static_cast<const void*>(&(*node)), Placement::template is_local<AllocTraits>(alloc, node));
+    };
+
+    // the descent of `find_impl()`
+    visit_node(header);
+    NodePtr node = header;
+    size_t elem_idx = 0;
+    for (NodePtr cursor = header->children[0]; cursor != nullptr;) {
+        visit_node(cursor);
+        const auto upper_bound = cursor->upper_bound(x, comp);
+        if (upper_bound == 0 || comp(cursor->elems[upper_bound - 1].get()->first, x)) {
+            cursor = cursor->children[upper_bound];
+        } else {
+            node = cursor;
+            elem_idx = upper_bound - 1;
+            break;
+        }
+    }
+
+    // the increments, as `BTreeIterBase::increment()`
+    for (size_t i = 0; i != n_increments && node != header; i++) {
+        const NodePtr& child = node->children[elem_idx + 1];
+        if (child == nullptr) {
+            if (elem_idx + 1 != node->n_elems) {
+                elem_idx++;
+            } else {
+                NodePtr cursor = node;
+                for (;;) {
+                    const NodePtr& parent = cursor->parent;
+                    visit_node(parent);
+                    if (parent->children[parent->n_elems] != cursor) {
+                        break;
+                    }
+                    cursor = parent;
+                }
+                node = cursor->parent;
+                elem_idx = std::ranges::find(node->children, cursor) - node->children.begin();
+            }
+        } else {
+            NodePtr cursor = child;
+            visit_node(cursor);
+            while (cursor->children[0] != nullptr) {
+                cursor = cursor->children[0];
+                visit_node(cursor);
+            }
+            node = cursor;
+            elem_idx = 0;
+        }
     }
 }
 
-}  // namespace FarMemoryContainer::PageAware
+}  // namespace FarMemoryContainer::Placed
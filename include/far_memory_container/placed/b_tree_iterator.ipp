@@ -1,13 +1,13 @@
 #pragma once
 
-#include <far_memory_container/page_aware/b_tree.hpp>
+#include <far_memory_container/placed/b_tree.hpp>
 
 #include <cstddef>
 #include <functional>
 #include <utility>
 
 
-namespace FarMemoryContainer::PageAware
+namespace FarMemoryContainer::Placed
 {
 
 template <class Node>
@@ -53,7 +53,7 @@ void BTreeIterBase<Node>::decrement()
                 cursor = cursor->parent;
             }
             node = cursor->parent;
-            elem_idx = std::ranges::find(node->children, cursor) - node->children.begin() + 1;
+            elem_idx = std::ranges::find(node->children, cursor) - node->children.begin() - 1;
         }
 
     } else {  // the node is a inner node
@@ -67,58 +67,58 @@ void BTreeIterBase<Node>::decrement()
 }
 
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::iterator::operator++() -> iterator&
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::iterator::operator++() -> iterator&
 {
     Base::increment();
     return *this;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::iterator::operator++(int) -> iterator
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::iterator::operator++(int) -> iterator
 {
     auto tmp = *this;
     ++(*this);
     return tmp;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::iterator::operator--() -> iterator&
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::iterator::operator--() -> iterator&
 {
     Base::decrement();
     return *this;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::iterator::operator--(int) -> iterator
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::iterator::operator--(int) -> iterator
 {
     auto tmp = *this;
     --(*this);
     return tmp;
 }
 
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::const_iterator::operator++() -> const_iterator&
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::const_iterator::operator++() -> const_iterator&
 {
     Base::increment();
     return *this;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::const_iterator::operator++(int) -> const_iterator
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::const_iterator::operator++(int) -> const_iterator
 {
     auto tmp = *this;
     ++(*this);
     return tmp;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::const_iterator::operator--() -> const_iterator&
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::const_iterator::operator--() -> const_iterator&
 {
     Base::decrement();
     return *this;
 }
-template <class Key, class T, size_t MaxNElems, class Compare, class Allocator>
-auto BTreeMap<Key, T, MaxNElems, Compare, Allocator>::const_iterator::operator--(int) -> const_iterator
+template <class Key, class T, size_t MaxNElems, class Compare, class Allocator, class Placement>
+auto BTreeMap<Key, T, MaxNElems, Compare, Allocator, Placement>::const_iterator::operator--(int) -> const_iterator
 {
     auto tmp = *this;
     --(*this);
     return tmp;
 }
 
-}  // namespace FarMemoryContainer::PageAware
+}  // namespace FarMemoryContainer::Placed
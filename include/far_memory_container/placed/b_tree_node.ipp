@@ -1,12 +1,12 @@
 #pragma once
 
-#include <far_memory_container/baseline/b_tree.hpp>
+#include <far_memory_container/placed/b_tree.hpp>
 
 #include <bit>
 #include <cstddef>
 
 
-namespace FarMemoryContainer::Baseline
+namespace FarMemoryContainer::Placed
 {
 
 template <class PtrToVal, size_t MaxNElems>
@@ -25,4 +25,4 @@ size_t BTreeNode<PtrToVal, MaxNElems>::upper_bound(const Key& key, key_compare&
     return pos;
 }
 
-}  // namespace FarMemoryContainer::Baseline
+}  // namespace FarMemoryContainer::Placed
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <farmalloc/collective_allocator_traits.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <utility>
+
+
+namespace FarMemoryContainer
+{
+using namespace FarMalloc;
+
+//! an object allocated by a placement policy, e.g., a node
+template <class T>
+struct SingleObject {
+    using type = T;
+    static constexpr size_t count() noexcept { return 1; }
+    static auto request() { return request::single<T>(); }
+};
+//! an array of objects allocated by a placement policy together with the other objects, e.g., the links of a node
+template <class T>
+struct ObjectArray {
+    using type = T;
+    size_t n;
+    constexpr size_t count() const noexcept { return n; }
+    auto request() const { return request::dynamic<T>(n); }
+};
+
+//! the ratio of a swap unit, i.e., a page of the collective allocator, filled by a batch placement before it moves on to a new one
+//! The rest is left for the nodes inserted near them later, and shared by the containers in `Blocked` and `PageAwarePlacement`.
+inline constexpr double MaxBatchOccupancy = 0.7;
+
+//! The placement policies decide where the containers in `Placed` allocate and relocate their nodes.
+//! All of their functions take the allocator traits of the first object `Traits`, and the objects are allocated together.
+//!   * `Block<Traits>` is the state of a batch placement, i.e., `batch_block()` and the bulk loading
+//!   * `new_block<Traits>(alloc, first_hint)` begins a batch placement
+//!   * `allocate<Traits>(alloc, near, objs...)` allocates a new node near `near`, e.g., its parent or its predecessor
+//!   * `place<Traits>(alloc, block, objs...)` allocates a node next to those placed previously in the batch
+//!   * `relocate<Traits>(alloc, block, move, ptrs, objs...)` relocates a node next to those placed previously in the batch
+//!   * `is_local<Traits>(alloc, ptr)` is whether `ptr` is in the purely local region
+//! The containers in `Blocked`, which manage the purely local region by themselves, use `PageAwarePlacement` for their batch placements.
+
+//! `hint`: each object is allocated by the hint allocator next to the previous one
+//! The objects are not co-allocated in a single request, and the purely local region is not used.
+struct HintPlacement {
+    //! the object placed last
+    template <class Traits>
+    using Block = typename Traits::pointer;
+
+    template <class Traits>
+    static Block<Traits> new_block(typename Traits::allocator_type&, const typename Traits::pointer& first_hint) { return first_hint; }
+
+    template <class Traits, class Ptr>
+    static constexpr bool is_local(typename Traits::allocator_type&, const Ptr&) noexcept { return false; }
+
+    template <class Traits, class Hint, class Obj, class... Objs>
+    static auto allocate(typename Traits::allocator_type& alloc, const Hint& near, const Obj& obj, const Objs&... objs)
+    {
+        using ObjTraits = typename Traits::template rebind_traits<typename Obj::type>;
+        typename ObjTraits::allocator_type obj_alloc{alloc};
+        auto ptr = ObjTraits::allocate(obj_alloc, obj.count(), near);
+        if constexpr (sizeof...(Objs) == 0) {
+            return std::tuple{std::move(ptr)};
+        } else {
+            // the next object is allocated next to this one
+            auto rest = allocate<Traits>(alloc, ptr, objs...);
+            return std::tuple_cat(std::tuple{std::move(ptr)}, std::move(rest));
+        }
+    }
+
+    template <class Traits, class... Objs>
+    static auto place(typename Traits::allocator_type& alloc, Block<Traits>& block, const Objs&... objs)
+    {
+        auto allocated = allocate<Traits>(alloc, block, objs...);
+        block = std::get<0>(allocated);
+        return allocated;
+    }
+
+    template <class Traits, class F, class... Ptrs, class... Objs>
+    static bool relocate(typename Traits::allocator_type& alloc, Block<Traits>& block, F&& move, std::tuple<Ptrs&...> ptrs, const Objs&... objs)
+    {
+        static_assert(sizeof...(Ptrs) == sizeof...(Objs));
+        auto to = allocate<Traits>(alloc, block, objs...);
+        const std::tuple<const Objs&...> objs_tuple{objs...};
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (move(std::to_address(std::get<I>(ptrs)), std::get<I>(objs_tuple).count(), std::to_address(std::get<I>(to))), ...);
+            (deallocate<Traits, typename Objs::type>(alloc, std::move(std::get<I>(ptrs)), objs.count()), ...);
+            ((std::get<I>(ptrs) = std::move(std::get<I>(to))), ...);
+        }(std::index_sequence_for<Objs...>{});
+        block = std::get<0>(ptrs);
+        return true;
+    }
+
+private:
+    template <class Traits, class U, class Ptr>
+    static void deallocate(typename Traits::allocator_type& alloc, Ptr&& ptr, size_t n)
+    {
+        using ObjTraits = typename Traits::template rebind_traits<U>;
+        typename ObjTraits::allocator_type obj_alloc{alloc};
+        ObjTraits::deallocate(obj_alloc, std::forward<Ptr>(ptr), n);
+    }
+};
+
+//! `page`, `dfs`, and `vEB`: the objects are co-allocated in the suballocator of a nearby node,
+//! and a batch placement packs them in a new page up to `MaxOccupancy`
+struct PageAwarePlacement {
+    //! the ratio of a page filled by a batch placement before it moves on to a new page
+    static constexpr double MaxOccupancy = MaxBatchOccupancy;
+
+    template <class Traits>
+    using Block = typename Traits::suballocator_traits::allocator_type;
+
+    template <class Traits>
+    static Block<Traits> new_block(typename Traits::allocator_type& alloc, const typename Traits::pointer&) { return Traits::get_suballocator(alloc, new_per_page); }
+
+    template <class Traits, class Ptr>
+    static bool is_local(typename Traits::allocator_type& alloc, const Ptr& ptr)
+    {
+        return Traits::if_suballocator_contains(alloc, Traits::get_suballocator(alloc, purely_local), ptr);
+    }
+
+    //! The objects fall back to the swappable region if the suballocator of `near` is full.
+    template <class Traits, class Hint, class... Objs>
+    static auto allocate(typename Traits::allocator_type& alloc, const Hint& near, const Objs&... objs)
+    {
+        using SuballocTraits = typename Traits::suballocator_traits;
+        auto suballoc = Traits::get_suballocator(alloc, near);
+        auto allocated = SuballocTraits::batch_allocate(suballoc, objs.request()...);
+        if (!allocated) {
+            auto suballoc = Traits::get_suballocator(alloc, swappable_plain);
+            allocated = SuballocTraits::batch_allocate(suballoc, objs.request()...);
+        }
+        if (!allocated) {
+            throw std::bad_alloc{};
+        }
+        return std::move(*allocated);
+    }
+
+    template <class Traits, class... Objs>
+    static auto place(typename Traits::allocator_type& alloc, Block<Traits>& block, const Objs&... objs)
+    {
+        using SuballocTraits = typename Traits::suballocator_traits;
+        if (!SuballocTraits::is_occupancy_under(block, MaxOccupancy)) {
+            block = Traits::get_suballocator(alloc, new_per_page);
+        }
+        auto allocated = SuballocTraits::batch_allocate(block, objs.request()...);
+        if (!allocated) {
+            block = Traits::get_suballocator(alloc, new_per_page);
+            allocated = SuballocTraits::batch_allocate(block, objs.request()...);
+        }
+        if (!allocated) {
+            // the objects do not fit in a page at all
+            auto suballoc = Traits::get_suballocator(alloc, swappable_plain);
+            allocated = SuballocTraits::batch_allocate(suballoc, objs.request()...);
+        }
+        if (!allocated) {
+            throw std::bad_alloc{};
+        }
+        return std::move(*allocated);
+    }
+
+    template <class Traits, class F, class... Ptrs, class... Objs>
+    static bool relocate(typename Traits::allocator_type& alloc, Block<Traits>& block, F&& move, std::tuple<Ptrs&...> ptrs, const Objs&... objs)
+    {
+        return relocate_by<Traits>(alloc, block, [&](Block<Traits>& suballoc) {
+            return Traits::relocate(alloc, suballoc, move, ptrs, objs.request()...);
+        });
+    }
+
+    //! `relocate` by the relocation of the container itself, e.g., the one of `Blocked` which also fixes up the links to the node
+    //! @param try_relocate relocates the objects into the suballocator given, and returns whether they have been relocated
+    //! (or throws `std::bad_alloc` if they have not)
+    //! @return whether the objects have been relocated; they stay where they are if they do not fit in a page at all
+    template <class Traits, class F>
+    static bool relocate_by(typename Traits::allocator_type& alloc, Block<Traits>& block, F&& try_relocate)
+    {
+        using SuballocTraits = typename Traits::suballocator_traits;
+        if (!SuballocTraits::is_occupancy_under(block, MaxOccupancy)) {
+            block = Traits::get_suballocator(alloc, new_per_page);
+        }
+        try {
+            if (try_relocate(block)) {
+                return true;
+            }
+        } catch (std::bad_alloc&) {
+        }
+        // The objects do not fit in the rest of the page.
+        block = Traits::get_suballocator(alloc, new_per_page);
+        try {
+            return try_relocate(block);
+        } catch (std::bad_alloc&) {
+            // They do not fit in a page at all, and stay where they are.
+            return false;
+        }
+    }
+};
+
+}  // namespace FarMemoryContainer
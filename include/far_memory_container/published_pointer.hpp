@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+
+
+namespace FarMemoryContainer
+{
+
+//! Pointer read by the lock-free readers while a writer may overwrite it, which otherwise behaves like `Ptr`.
+//! A store releases and a load acquires, so that a node initialized before its pointer is stored is seen initialized by the readers.
+template <class Ptr>
+class PublishedPointer
+{
+    std::atomic<Ptr> ptr;
+
+public:
+    PublishedPointer(const Ptr& p = nullptr) noexcept : ptr(p) {}
+    PublishedPointer(const PublishedPointer& other) noexcept : ptr(other.load()) {}
+    PublishedPointer& operator=(const PublishedPointer& other) noexcept
+    {
+        store(other.load());
+        return *this;
+    }
+    PublishedPointer& operator=(const Ptr& p) noexcept
+    {
+        store(p);
+        return *this;
+    }
+
+    Ptr load() const noexcept { return ptr.load(std::memory_order_acquire); }
+    void store(const Ptr& p) noexcept { ptr.store(p, std::memory_order_release); }
+
+    operator Ptr() const noexcept { return load(); }
+    Ptr operator->() const noexcept { return load(); }
+};
+
+}  // namespace FarMemoryContainer
@@ -1,152 +1,574 @@
 #pragma once
 
 #include "setting_basis.hpp"
+#include "workload.hpp"
+
+#include <far_memory_container/access_trace.hpp>
+#include <farmalloc/local_memory_store.hpp>
+#include <farmalloc/page_size.hpp>
+
+#include <umap/umap.h>
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <iostream>
+#include <latch>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <ostream>
 #include <random>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+void read(Mapped);
+
+//! the kind of a query, to which the swapping during it is attributed
+struct QueryKind {
+    Task task;
+    //! the number of the elements to read in a range query, or 0 for the other queries
+    size_t range_length = 0;
+};
+
+//! guards of the mapped values against concurrent updates in the multi-threaded queries
+//! The containers themselves are only read during the queries, so `find` and iteration need no guard,
+//! unless the workload inserts or erases elements (see `lock_structure`).
+inline std::array<std::mutex, 1024> mapped_value_mutexes;
+
+//! @param values_written whether the workload updates any mapped value
+template <bool Concurrent>
+inline std::unique_lock<std::mutex> lock_mapped_value(Key key, bool values_written)
+{
+    if (Concurrent && values_written) {
+        return std::unique_lock{mapped_value_mutexes[key % mapped_value_mutexes.size()]};
+    } else {
+        // read-only fast path: no update races with the reads
+        return {};
+    }
+}
+
+//! the containers are not thread-safe, so an insertion or erasure excludes all the other operations
+template <bool Concurrent>
+inline std::shared_lock<std::shared_mutex> lock_structure(WorkloadGenerator& generator)
+{
+    if (Concurrent && generator.workload().modifies_structure()) {
+        return std::shared_lock{generator.keys().structure_mutex};
+    } else {
+        return {};
+    }
+}
+template <bool Concurrent>
+inline std::unique_lock<std::shared_mutex> lock_structure_exclusively(WorkloadGenerator& generator)
+{
+    if (Concurrent) {
+        return std::unique_lock{generator.keys().structure_mutex};
+    } else {
+        return {};
+    }
+}
 
+//! asks UMap to swap in the pages of the objects given by a scan asynchronously
+//! The consecutive hints for the same page are merged.
+struct PagePrefetcher {
+    uintptr_t last_page = 0;
 
-constexpr double ZipfSkewness = Zipf_skewness;
-constexpr double UpdateRatio = Update_ratio;
+    void operator()(const void* address, size_t size)
+    {
+        const auto first = reinterpret_cast<uintptr_t>(address);
+        for (auto page = first & ~uintptr_t{SwapUnitSize - 1}; page < first + size; page += SwapUnitSize) {
+            if (page != last_page) {
+                umap_prefetch_item item{.page_base_addr = reinterpret_cast<void*>(page)};
+                umap_prefetch(1, &item);
+                last_page = page;
+            }
+        }
+    }
+};
 
-template <class UIntType>
-struct Zipf_distribution {
-    using result_type = UIntType;
+//! finds `key` from `finger`, the result of the previous lookup of the thread, if `Workload::finger_search` and the container supports it
+template <class MapType>
+inline typename MapType::iterator find_from_finger(MapType& map, Key key, const Workload& workload, std::optional<typename MapType::iterator>& finger)
+{
+    if constexpr (requires { map.find(map.end(), key); }) {
+        if (workload.finger_search) {
+            auto iter = map.find(finger.value_or(map.end()), key);
+            if (iter != map.end()) {
+                finger = iter;
+            }
+            return iter;
+        }
+    }
+    return map.find(key);
+}
 
-    static_assert(NumElements > 0);
-    static_assert(ZipfSkewness > 0);
+//! runs an operation drawn by `generator`
+//! The reads and updates of an erased key find nothing, and do nothing.
+//! @param finger the result of the previous lookup of the thread (see `find_from_finger`)
+template <bool Concurrent = false, class URBG, class MapType>
+inline QueryKind workload_step(URBG& prng, MapType& map, WorkloadGenerator& generator, std::optional<typename MapType::iterator>& finger)
+{
+    const bool values_written = generator.workload().writes_values();
+    const auto find = [&](Key key) { return find_from_finger(map, key, generator.workload(), finger); };
 
-    constexpr static double h_integral(double x)
+    switch (generator.operation(prng)) {
+    case WorkloadGenerator::PointRead: {
+        const auto structure_lock = lock_structure<Concurrent>(generator);
+        if (const size_t batch = generator.workload().read_batch; batch != 1) {
+            static thread_local std::vector<Key> keys;
+            static thread_local std::vector<typename MapType::iterator> found;
+            keys.resize(batch);
+            found.resize(batch);
+            for (auto& key : keys) {
+                key = generator.key(prng);
+            }
+            if constexpr (requires { map.multi_find(std::span<const Key>{keys}, std::span{found}, PagePrefetcher{}); }) {
+                map.multi_find(std::span<const Key>{keys}, std::span{found}, PagePrefetcher{});
+            } else {
+                std::ranges::transform(keys, found.begin(), [&](const Key& key) { return find(key); });
+            }
+            for (const auto& iter : found) {
+                if (iter != map.end()) {
+                    const auto lock = lock_mapped_value<Concurrent>(iter->first, values_written);
+                    read(iter->second);
+                }
+            }
+            return {.task = Read};
+        }
+        if (auto iter = find(generator.key(prng)); iter != map.end()) {
+            const auto lock = lock_mapped_value<Concurrent>(iter->first, values_written);
+            read(iter->second);
+        }
+        return {.task = Read};
+    }
+
+    case WorkloadGenerator::Scan: {
+        const auto structure_lock = lock_structure<Concurrent>(generator);
+        const auto key = generator.key(prng);
+        const auto n_read = generator.range_length(prng);
+        if constexpr (requires { map.scan(key, n_read, [](auto&) {}, PagePrefetcher{}); }) {
+            if (generator.workload().scan_prefetch) {
+                map.scan(key, n_read, [&](auto& value) {
+                    const auto lock = lock_mapped_value<Concurrent>(value.first, values_written);
+                    read(value.second);
+                },
+                    PagePrefetcher{});
+                return {.task = Read, .range_length = n_read};
+            }
+        }
+        auto iter = find(key);
+        for (size_t i = 0; i < n_read && iter != map.end(); i++, iter++) {
+            const auto lock = lock_mapped_value<Concurrent>(iter->first, values_written);
+            read(iter->second);
+        }
+        return {.task = Read, .range_length = n_read};
+    }
+
+    case WorkloadGenerator::PointUpdate: {
+        auto value = random_bytes(prng);
+        const auto structure_lock = lock_structure<Concurrent>(generator);
+        if (auto iter = find(generator.key(prng)); iter != map.end()) {
+            const auto lock = lock_mapped_value<Concurrent>(iter->first, values_written);
+            iter->second = std::move(value);
+        }
+        return {.task = Update};
+    }
+
+    case WorkloadGenerator::ReadModification: {
+        auto value = random_bytes(prng);
+        const auto structure_lock = lock_structure<Concurrent>(generator);
+        if (auto iter = find(generator.key(prng)); iter != map.end()) {
+            const auto lock = lock_mapped_value<Concurrent>(iter->first, values_written);
+            read(iter->second);
+            iter->second = std::move(value);
+        }
+        return {.task = ReadModifyWrite};
+    }
+
+    case WorkloadGenerator::Insertion: {
+        auto value = random_bytes(prng);
+        const auto structure_lock = lock_structure_exclusively<Concurrent>(generator);
+        map.insert({generator.new_key(), std::move(value)});
+        return {.task = Insert};
+    }
+
+    case WorkloadGenerator::Erasure:
+    default: {
+        const auto structure_lock = lock_structure_exclusively<Concurrent>(generator);
+        if (const auto key = generator.erased_key(prng)) {
+            map.erase(*key);
+        }
+        return {.task = Erase};
+    }
+    }
+}
+
+//! HDR-style histogram of latencies, whose buckets are linear within each power of two
+//! The value recorded in a bucket is reported as the largest one in the bucket, within the relative error of 2^-SubBucketBits.
+struct LatencyHistogram {
+    static constexpr size_t SubBucketBits = 7;
+    static constexpr size_t NSubBuckets = size_t{1} << SubBucketBits;
+    static constexpr size_t NBuckets = (64 - SubBucketBits + 1) * NSubBuckets;
+
+    std::array<uint64_t, NBuckets> counts{};
+    uint64_t n_recorded = 0;
+    std::chrono::nanoseconds sum{}, max{};
+
+    static constexpr size_t bucket_idx(uint64_t value)
+    {
+        if (value < NSubBuckets) {
+            return value;
+        }
+        const size_t shift = std::bit_width(value) - SubBucketBits - 1;
+        return (shift + 1) * NSubBuckets + ((value >> shift) - NSubBuckets);
+    }
+    static constexpr uint64_t highest_equivalent_value(size_t idx)
+    {
+        if (idx < NSubBuckets) {
+            return idx;
+        }
+        const size_t shift = idx / NSubBuckets - 1;
+        return ((NSubBuckets + idx % NSubBuckets) << shift) + ((uint64_t{1} << shift) - 1);
+    }
+
+    void record(std::chrono::nanoseconds latency)
+    {
+        counts[bucket_idx(static_cast<uint64_t>(latency.count()))]++;
+        n_recorded++;
+        sum += latency;
+        max = std::max(max, latency);
+    }
+    LatencyHistogram& operator+=(const LatencyHistogram& other)
     {
-        using std::log;
-        const double log_x = log(x);
-        return helper2((1.0 - ZipfSkewness) * log_x) * log_x;
+        for (size_t i = 0; i != NBuckets; i++) {
+            counts[i] += other.counts[i];
+        }
+        n_recorded += other.n_recorded;
+        sum += other.sum;
+        max = std::max(max, other.max);
+        return *this;
     }
-    constexpr static double h(double x)
+
+    std::chrono::nanoseconds mean() const
     {
-        using std::exp;
-        using std::log;
-        return exp(-ZipfSkewness * log(x));
+        return sum / std::max<uint64_t>(n_recorded, 1);
     }
-    constexpr static double h_integral_inv(double x)
+    //! @param percentile in [0, 100]
+    std::chrono::nanoseconds percentile(double percentile) const
     {
-        using std::exp;
-        using std::max;
-        return exp(helper1(max({-1.0, x * (1 - ZipfSkewness)})) * x);
+        const auto rank = static_cast<uint64_t>(std::ceil(percentile / 100 * static_cast<double>(n_recorded)));
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i != NBuckets; i++) {
+            cumulative += counts[i];
+            if (cumulative >= std::max<uint64_t>(rank, 1)) {
+                return std::min(std::chrono::nanoseconds{highest_equivalent_value(i)}, max);
+            }
+        }
+        return max;
     }
-    constexpr static double helper1(double x)
+};
+
+//! distributions of the number of the pages swapped in during a query, for each kind of the queries
+//! The swapping counters are shared by all the threads, so the attribution is exact only with a single thread.
+struct SwapAttribution {
+    //! 0: update, 1: point read, 1 + l: range read of length l, followed by insertion, erasure, and read-modify-write
+    static constexpr size_t NKinds = MaxRangeLength + 5;
+    static constexpr size_t InsertKind = MaxRangeLength + 2, EraseKind = MaxRangeLength + 3, ReadModifyWriteKind = MaxRangeLength + 4;
+
+    static constexpr size_t kind_idx(QueryKind kind)
     {
-        using std::abs;
-        using std::log1p;
-        if (abs(x) > 1e-8) {
-            return log1p(x) / x;
-        } else {
-            return 1.0 - x * (0.5 - x * (1.0 / 3 - x / 4));
+        switch (kind.task) {
+        case Update:
+            return 0;
+        case Read:
+            return 1 + kind.range_length;
+        case Insert:
+            return InsertKind;
+        case Erase:
+            return EraseKind;
+        case ReadModifyWrite:
+        default:
+            return ReadModifyWriteKind;
         }
     }
-    constexpr static double helper2(double x)
+    static constexpr const char* task_name(size_t kind)
     {
-        using std::abs;
-        using std::expm1;
-        if (abs(x) > 1e-8) {
-            return expm1(x) / x;
-        } else {
-            return 1.0 + x / 2 * (1.0 + x / 3 * (1.0 + x / 4));
+        switch (kind) {
+        case 0:
+            return "update";
+        case InsertKind:
+            return "insert";
+        case EraseKind:
+            return "erase";
+        case ReadModifyWriteKind:
+            return "read_modify_write";
+        default:
+            return "read";
         }
     }
 
-    static constexpr double h_integral_x1 = h_integral(1.5) - 1.0;
-    static constexpr double h_integral_num_elements = h_integral(double{NumElements} + 0.5);
-    static constexpr double s = 2.0 - h_integral_inv(h_integral(2.5) - h(2.0));
+    struct Bin {
+        uint64_t n_queries = 0;
+        //! the total number of the pages swapped out during the queries
+        uint64_t swap_outs = 0;
+    };
+    //! histograms[kind][n]: the queries during which n pages were swapped in
+    std::array<std::vector<Bin>, NKinds> histograms;
 
-private:
-    inline static std::uniform_real_distribution<double> real_distribution{-h_integral_num_elements, -h_integral_x1};
+    void record(QueryKind kind, size_t swap_ins, size_t swap_outs)
+    {
+        auto& histogram = histograms[kind_idx(kind)];
+        if (histogram.size() <= swap_ins) {
+            histogram.resize(swap_ins + 1);
+        }
+        histogram[swap_ins].n_queries++;
+        histogram[swap_ins].swap_outs += swap_outs;
+    }
+    SwapAttribution& operator+=(const SwapAttribution& other)
+    {
+        for (size_t kind = 0; kind != NKinds; kind++) {
+            auto& histogram = histograms[kind];
+            const auto& other_histogram = other.histograms[kind];
+            histogram.resize(std::max(histogram.size(), other_histogram.size()));
+            for (size_t n = 0; n != other_histogram.size(); n++) {
+                histogram[n].n_queries += other_histogram[n].n_queries;
+                histogram[n].swap_outs += other_histogram[n].swap_outs;
+            }
+        }
+        return *this;
+    }
 
-public:
-    template <class URBG>
-    constexpr result_type operator()(URBG& g) const
+    //! @return the total number of the pages swapped in during the queries of the kinds in [first_kind, last_kind)
+    uint64_t swap_ins(size_t first_kind, size_t last_kind) const
     {
-        using std::clamp;
-        using std::max;
-        for (;;) {
-            const double u = -real_distribution(g);
-            const double x = h_integral_inv(u);
-            const UIntType k = clamp<UIntType>(static_cast<UIntType>(x), 1, NumElements);
-            const double k_double = static_cast<double>(k);
+        uint64_t res = 0;
+        for (size_t kind = first_kind; kind != last_kind; kind++) {
+            for (size_t n = 0; n != histograms[kind].size(); n++) {
+                res += n * histograms[kind][n].n_queries;
+            }
+        }
+        return res;
+    }
+    uint64_t update_swap_ins() const { return swap_ins(0, 1); }
+    uint64_t point_read_swap_ins() const { return swap_ins(1, 2); }
+    uint64_t range_read_swap_ins() const { return swap_ins(2, InsertKind); }
+    uint64_t insert_swap_ins() const { return swap_ins(InsertKind, InsertKind + 1); }
+    uint64_t erase_swap_ins() const { return swap_ins(EraseKind, EraseKind + 1); }
 
-            if (k_double - x <= s || u >= h_integral(k_double + 0.5) - h(k_double)) {
-                return UIntType{k - 1};
+    //! prints the distributions as comment lines, which follow the result line of a benchmark
+    void print(std::ostream& os) const
+    {
+        os << "#swap_in_distribution\t"
+           << "task\t"
+           << "range_length\t"
+           << "swap_ins\t"
+           << "n_queries\t"
+           << "swap_outs" << '\n';
+        for (size_t kind = 0; kind != NKinds; kind++) {
+            for (size_t n = 0; n != histograms[kind].size(); n++) {
+                if (histograms[kind][n].n_queries == 0) {
+                    continue;
+                }
+                os << "#swap_in_distribution\t"
+                   << task_name(kind) << '\t'
+                   << (kind == 0 || kind >= InsertKind ? 0 : kind - 1) << '\t'
+                   << n << '\t'
+                   << histograms[kind][n].n_queries << '\t'
+                   << histograms[kind][n].swap_outs << '\n';
             }
         }
+        os << std::flush;
     }
 };
-enum ReadOrUpdate {
-    Read,
-    Update
+
+struct QueryResult {
+    //! from the start of the first thread to the end of the last thread
+    std::chrono::nanoseconds duration{};
+    //! latencies of the operations for each thread
+    std::vector<LatencyHistogram> latencies;
+    //! remote swapping during the operations for each thread
+    std::vector<SwapAttribution> swaps;
+
+    SwapAttribution merged_swaps() const
+    {
+        SwapAttribution res;
+        for (const auto& per_thread : swaps) {
+            res += per_thread;
+        }
+        return res;
+    }
+
+    LatencyHistogram merged_latencies() const
+    {
+        LatencyHistogram res;
+        for (const auto& per_thread : latencies) {
+            res += per_thread;
+        }
+        return res;
+    }
+    size_t n_operations() const
+    {
+        size_t res = 0;
+        for (const auto& per_thread : latencies) {
+            res += per_thread.n_recorded;
+        }
+        return res;
+    }
+    //! @return [operations/s]
+    double throughput() const
+    {
+        if (duration.count() == 0) {
+            return 0.0;
+        }
+        return static_cast<double>(n_operations()) * 1e9 / static_cast<double>(duration.count());
+    }
+    std::chrono::nanoseconds mean_latency() const { return merged_latencies().mean(); }
+    std::chrono::nanoseconds max_latency() const { return merged_latencies().max; }
+    //! @return [p50, p99, p99.9] of the latencies
+    std::array<std::chrono::nanoseconds, 3> tail_latencies() const
+    {
+        const auto merged = merged_latencies();
+        return {merged.percentile(50), merged.percentile(99), merged.percentile(99.9)};
+    }
 };
-template <class URBG>
-ReadOrUpdate generate_task(URBG&& engine)
+
+//! runs `n_iterations` operations by `step` on each of `n_threads` threads, each of which has its own PRNG and its own copy of `step`
+//! The calling thread works as the 0th thread with `prng`, so that a single thread reproduces the sequential benchmark.
+template <class URBG, class MapType, class Step>
+inline QueryResult parallel_query(URBG& prng, MapType& map, size_t n_iterations, size_t n_threads, const Step& step)
 {
-    static std::bernoulli_distribution dist{UpdateRatio};
-    return dist(engine) ? Update : Read;
-}
+    using clock = std::chrono::high_resolution_clock;
 
-void read(Mapped);
+    QueryResult result{.latencies = std::vector<LatencyHistogram>(n_threads), .swaps = std::vector<SwapAttribution>(n_threads)};
+    std::vector<clock::time_point> begin_times(n_threads), end_times(n_threads);
+    std::latch start_line{static_cast<std::ptrdiff_t>(n_threads)};
+
+    const auto run = [&](size_t thread_idx, URBG& engine) {
+        auto& latencies = result.latencies[thread_idx];
+        auto& swaps = result.swaps[thread_idx];
+        auto thread_step = step;
 
+        start_line.arrive_and_wait();
+        size_t read_cnt = FarMalloc::LocalMemoryStore::read_cnt, write_cnt = FarMalloc::LocalMemoryStore::write_cnt;
+        auto op_begin_time = clock::now(), op_end_time = op_begin_time;
+        begin_times[thread_idx] = op_begin_time;
+        for (auto i = n_iterations; i != 0; i--) {
+            const QueryKind kind = thread_step(engine, map);
+            op_end_time = clock::now();
+            latencies.record(std::chrono::duration_cast<std::chrono::nanoseconds>(op_end_time - op_begin_time));
+
+            const size_t new_read_cnt = FarMalloc::LocalMemoryStore::read_cnt, new_write_cnt = FarMalloc::LocalMemoryStore::write_cnt;
+            swaps.record(kind, new_read_cnt - read_cnt, new_write_cnt - write_cnt);
+            read_cnt = new_read_cnt;
+            write_cnt = new_write_cnt;
+            // The bookkeeping above is not charged to the latency of the next operation.
+            op_begin_time = clock::now();
+        }
+        end_times[thread_idx] = op_end_time;
+    };
+
+    {
+        std::vector<std::jthread> workers;
+        for (size_t thread_idx = 1; thread_idx < n_threads; thread_idx++) {
+            workers.emplace_back([&, thread_idx] {
+                std::seed_seq seeds{thread_idx};
+                URBG engine{seeds};
+                run(thread_idx, engine);
+            });
+        }
+        run(0, prng);
+    }
+
+    result.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        *std::max_element(end_times.begin(), end_times.end()) - *std::min_element(begin_times.begin(), begin_times.end()));
+    return result;
+}
+
+//! runs `workload` on `n_threads` threads, which share the keys in the container
+//! @param key_space the keys after the construction or the previous workload, updated by `workload`
 template <class URBG, class MapType>
-inline std::chrono::nanoseconds search(URBG& prng, MapType& map)
+inline QueryResult parallel_workload(URBG& prng, MapType& map, const Workload& workload, size_t n_threads, KeySpace& key_space)
 {
-    constexpr Zipf_distribution<uint64_t> zipf;
+    WorkloadGenerator generator{workload, key_space};
 
-    const auto begin_time = std::chrono::high_resolution_clock::now();
-    for (auto i = NIteration; i != 0; i--) {
-        Key key = FNV_hash(zipf(prng));
-        if (generate_task(prng) == Update) {
-            map.find(key)->second = random_bytes(prng);
-        } else {
-            read(map.find(key)->second);
+    if constexpr (requires { map.promote_hot_nodes(size_t{}); }) {
+        if (workload.promotion_period != 0 && n_threads != 1) {
+            // The lookups relocate the nodes.
+            throw std::invalid_argument{"workload: promote needs a single thread"};
         }
+        map.promote_hot_nodes(workload.promotion_period);
+    }
+
+    if (n_threads == 1) {
+        return parallel_query(prng, map, workload.n_iterations, 1, [generator, finger = std::optional<typename MapType::iterator>{}](URBG& engine, MapType& map) mutable { return workload_step<false>(engine, map, generator, finger); });
     }
-    const auto end_time = std::chrono::high_resolution_clock::now();
-    return std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - begin_time);
+    return parallel_query(prng, map, workload.n_iterations, n_threads, [generator, finger = std::optional<typename MapType::iterator>{}](URBG& engine, MapType& map) mutable { return workload_step<true>(engine, map, generator, finger); });
 }
 
-template <class URBG, class MapType>
-inline std::chrono::nanoseconds range_query(URBG& prng, MapType& map)
+//! pins the elements of the `workload.n_pinned` hottest keys in the purely local region, if the container supports it (see `pin`)
+template <class MapType>
+inline void pin_hot_values(MapType& map, const Workload& workload, const KeySpace& key_space)
 {
-    constexpr Zipf_distribution<uint64_t> zipf;
-    std::uniform_int_distribution<size_t> uniform{1, 100};
-
-    const auto begin_time = std::chrono::high_resolution_clock::now();
-    for (auto i = NIteration; i != 0; i--) {
-        Key key = FNV_hash(zipf(prng));
-        if (generate_task(prng) == Update) {
-            map.find(key)->second = random_bytes(prng);
-        } else {
-            const auto n_read = uniform(prng);
-            auto iter = map.find(key);
-            for (size_t i = 0; i < n_read && iter != map.end(); i++, iter++) {
-                read(iter->second);
+    if constexpr (requires { map.pin(Key{}); }) {
+        const auto size = key_space.size();
+        for (uint64_t r = 0; r < std::min<uint64_t>(workload.n_pinned, size); r++) {
+            const auto rank = workload.key_distribution == KeyDistribution::Latest ? size - 1 - r : r;
+            if (!map.pin(FNV_hash(key_space.id(rank)))) {
+                // The purely local region is full.
+                break;
             }
         }
     }
-    const auto end_time = std::chrono::high_resolution_clock::now();
-    return std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - begin_time);
+}
+
+//! records the accesses of the queries of `workload` into `workload.trace_path` (see `AccessTraceWriter`), without running them
+//! It is called before remote swapping is enabled, and the trace is replayed by `replay_trace` for any size of the page cache.
+//! The queries are those of a single thread.
+//! @throw std::invalid_argument if the container does not support it
+template <class URBG, class MapType>
+inline void trace_workload(URBG& prng, MapType& map, const Workload& workload, KeySpace& key_space)
+{
+    if constexpr (requires { map.visit_query(Key{}, size_t{}, [](const void*, bool) {}); }) {
+        FarMemoryContainer::AccessTraceWriter trace{workload.trace_path, SwapUnitSize};
+        visit_workload(prng, map, workload, key_space, trace, [&] { trace.end_query(); });
+        trace.flush();
+
+        std::cout << "#trace\t" << workload.trace_path << '\t' << trace.n_queries() << " queries" << std::endl;
+    } else {
+        throw std::invalid_argument{"workload: the container does not support trace"};
+    }
+}
+
+template <class URBG, class MapType>
+inline QueryResult parallel_workload(URBG& prng, MapType& map, const Workload& workload, size_t n_threads)
+{
+    KeySpace key_space{workload};
+    return parallel_workload(prng, map, workload, n_threads, key_space);
+}
+
+//! the sequential benchmark, i.e., the multi-threaded one with a single thread
+template <class URBG, class MapType>
+inline QueryResult query(URBG& prng, MapType& map, const Workload& workload)
+{
+    return parallel_workload(prng, map, workload, 1);
 }
 
 template <class MapType>
-inline std::array<std::chrono::nanoseconds, 2> benchmark(MapType& map)
+inline std::array<std::chrono::nanoseconds, 2> benchmark(MapType& map, const Workload& workload = {})
 {
     std::mt19937 prng;
 
     std::array<std::chrono::nanoseconds, 2> result;
-    result[0] = construct(prng, map);
-    result[1] = search(prng, map);
+    result[0] = construct(prng, map, workload.n_elements);
+    result[1] = query(prng, map, workload).duration;
 
     return result;
 }
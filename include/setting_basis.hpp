@@ -1,12 +1,17 @@
 #pragma once
 
+#include <farmalloc/page_size.hpp>
+
+#include <algorithm>
 #include <array>
 #include <bit>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <ranges>
 #include <utility>
 #include <random>
+#include <vector>
 
 
 constexpr int SERVER_RANK = 1;
@@ -16,14 +21,36 @@ using Key = uint64_t;
 using Mapped = std::array<std::byte, 150>;
 using ValueType = std::pair<const Key, Mapped>;
 
+// the defaults of `Workload::n_elements` and `Workload::n_iterations`, and the number of the elements in the edge analyses
 constexpr size_t NumElements = 13421773;  // 2GB
 constexpr size_t NIteration = 10000;
+// the maximum number of the elements in a node of the B-trees, 2 (a 2-3 tree) unless the build gives another (see CMakeLists.txt)
+// 24 elements of `ValueType` fill a node of nearly 4 KiB.
+#ifndef B_TREE_MAX_N_ELEMS
+#define B_TREE_MAX_N_ELEMS 2
+#endif
+constexpr size_t BTreeMaxNElems = B_TREE_MAX_N_ELEMS;
+// the size of the pages of the collective allocators, i.e., the unit of remote swapping, `PageSize` (4 KiB) unless the build gives another,
+// e.g., 64 KiB or a 2 MiB huge page (see CMakeLists.txt); `UMAP_PAGESIZE` must be the same (see scripts/kvs_benchmark.sh)
+#ifndef SWAP_UNIT_SIZE
+#define SWAP_UNIT_SIZE PageSize
+#endif
+constexpr size_t SwapUnitSize = SWAP_UNIT_SIZE;
+static_assert(SwapUnitSize % PageSize == 0, "a swap unit consists of whole pages");
 
 enum BlockingMode : int {
     None = 0,
     DepthFirst,
-    vEB
+    vEB,
+    IncrementalDepthFirst,
+    IncrementalvEB,
+    BulkLoadDepthFirst,
+    BulkLoadvEB,
+    // vEB of the subtrees fitting in a page of `PageSize` bytes within the swap units of `SwapUnitSize` bytes
+    MultiLevelvEB
 };
+// the number of insertions/erasures between incremental rearrangements
+constexpr size_t IncrementalBlockingPeriod = 1024;
 
 inline Key FNV_hash(uint64_t x)
 {
@@ -40,7 +67,7 @@ inline Key FNV_hash(uint64_t x)
 template <class URBG>
 Mapped random_bytes(URBG&& engine)
 {
-    static std::uniform_int_distribution<unsigned char> dist;
+    static thread_local std::uniform_int_distribution<unsigned char> dist;
     Mapped result;
     for (auto& byte : result) {
         byte = static_cast<std::byte>(dist(engine));
@@ -49,12 +76,30 @@ Mapped random_bytes(URBG&& engine)
 }
 
 template <class URBG, class MapType>
-inline std::chrono::nanoseconds construct(URBG& prng, MapType& map)
+inline std::chrono::nanoseconds construct(URBG& prng, MapType& map, size_t n_elements = NumElements)
 {
     const auto begin_time = std::chrono::high_resolution_clock::now();
-    for (uint64_t i{NumElements}; i != 0; i--) {
+    for (uint64_t i{n_elements}; i != 0; i--) {
         map.insert({FNV_hash(i - 1), random_bytes(prng)});
     }
     const auto end_time = std::chrono::high_resolution_clock::now();
     return std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - begin_time);
 }
+//! constructs the same set of keys as `construct` by bulk loading in ascending order of the keys
+//! @param bulk_load called with a sized range of `ValueType` sorted by the key
+template <class URBG, class BulkLoad>
+inline std::chrono::nanoseconds bulk_construct(URBG& prng, BulkLoad&& bulk_load, size_t n_elements = NumElements)
+{
+    const auto begin_time = std::chrono::high_resolution_clock::now();
+    std::vector<Key> keys(n_elements);
+    for (uint64_t i = 0; i != n_elements; i++) {
+        keys[i] = FNV_hash(i);
+    }
+    std::ranges::sort(keys);
+    keys.erase(std::ranges::unique(keys).begin(), keys.end());
+
+    auto sorted = keys | std::views::transform([&](Key key) { return ValueType{key, random_bytes(prng)}; });
+    bulk_load(sorted);
+    const auto end_time = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - begin_time);
+}
@@ -0,0 +1,634 @@
+#pragma once
+
+#include "setting_basis.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <shared_mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+// the upper bound of the lengths of the range queries
+constexpr size_t MaxRangeLength = 100;
+
+//! Zipf distribution over [0, n), sampled by rejection-inversion
+template <class UIntType>
+struct Zipf_distribution {
+    using result_type = UIntType;
+
+    const size_t n;
+    const double skewness;
+
+    Zipf_distribution(size_t n, double skewness)
+        : n(n), skewness(skewness),
+          h_integral_x1(h_integral(1.5) - 1.0),
+          h_integral_n(h_integral(static_cast<double>(n) + 0.5)),
+          s(2.0 - h_integral_inv(h_integral(2.5) - h(2.0)))
+    {
+        if (n == 0 || !(skewness > 0)) {
+            throw std::invalid_argument{"Zipf_distribution: n and skewness must be positive"};
+        }
+    }
+
+    double h_integral(double x) const
+    {
+        using std::log;
+        const double log_x = log(x);
+        return helper2((1.0 - skewness) * log_x) * log_x;
+    }
+    double h(double x) const
+    {
+        using std::exp;
+        using std::log;
+        return exp(-skewness * log(x));
+    }
+    double h_integral_inv(double x) const
+    {
+        using std::exp;
+        using std::max;
+        return exp(helper1(max({-1.0, x * (1 - skewness)})) * x);
+    }
+    static double helper1(double x)
+    {
+        using std::abs;
+        using std::log1p;
+        if (abs(x) > 1e-8) {
+            return log1p(x) / x;
+        } else {
+            return 1.0 - x * (0.5 - x * (1.0 / 3 - x / 4));
+        }
+    }
+    static double helper2(double x)
+    {
+        using std::abs;
+        using std::expm1;
+        if (abs(x) > 1e-8) {
+            return expm1(x) / x;
+        } else {
+            return 1.0 + x / 2 * (1.0 + x / 3 * (1.0 + x / 4));
+        }
+    }
+
+    const double h_integral_x1;
+    const double h_integral_n;
+    const double s;
+
+    template <class URBG>
+    result_type operator()(URBG& g) const
+    {
+        using std::clamp;
+        std::uniform_real_distribution<double> real_distribution{-h_integral_n, -h_integral_x1};
+        for (;;) {
+            const double u = -real_distribution(g);
+            const double x = h_integral_inv(u);
+            const UIntType k = clamp<UIntType>(static_cast<UIntType>(x), 1, n);
+            const double k_double = static_cast<double>(k);
+
+            if (k_double - x <= s || u >= h_integral(k_double + 0.5) - h(k_double)) {
+                return UIntType{k - 1};
+            }
+        }
+    }
+};
+
+enum Task {
+    Read,
+    Update,
+    Insert,
+    Erase,
+    ReadModifyWrite
+};
+
+//! how the keys of the operations are chosen among the keys in the container, ranked as in `KeySpace`
+enum class KeyDistribution {
+    //! Zipf distribution, the higher ranked the hotter
+    Zipfian,
+    Uniform,
+    //! Zipf distribution, the lower ranked (i.e., the more recently inserted) the hotter
+    Latest
+};
+enum class RangeLengthDistribution {
+    //! uniform in [1, max_range_length]
+    Uniform,
+    //! always max_range_length
+    Constant
+};
+
+//! parameters of the key-value store benchmark, given at run time
+//! The proportions of the operations are relative to each other, i.e., they need not sum up to 1.
+//! By default, it is the original benchmark: range reads of uniform lengths and 5% updates on Zipfian keys with skewness 0.8.
+struct Workload {
+    //! the number of the elements inserted before the queries
+    size_t n_elements = NumElements;
+    //! the number of the operations run by each thread
+    size_t n_iterations = NIteration;
+
+    KeyDistribution key_distribution = KeyDistribution::Zipfian;
+    double zipf_skewness = 0.8;
+
+    double read_proportion = 0.0;
+    double scan_proportion = 0.95;
+    double update_proportion = 0.05;
+    double insert_proportion = 0.0;
+    double read_modify_write_proportion = 0.0;
+    double erase_proportion = 0.0;
+
+    RangeLengthDistribution range_length_distribution = RangeLengthDistribution::Uniform;
+    size_t max_range_length = MaxRangeLength;
+    //! the number of the keys looked up together by a point read, interleaved by `multi_find` if the container supports it
+    size_t read_batch = 1;
+    //! whether each lookup of a thread starts from the result of its previous one (see `find(hint, key)` of the containers),
+    //! if the container supports it; only without insertions and erasures, which may invalidate the results
+    bool finger_search = false;
+    //! whether the range reads hint the upcoming nodes to UMap to swap them in ahead, if the container supports it (see `scan`)
+    bool scan_prefetch = false;
+    //! the number of the sampled lookups between the rounds promoting the hot nodes into the purely local region,
+    //! if the container supports it (see `promote_hot_nodes`); 0 to keep the placement structural
+    size_t promotion_period = 0;
+    //! the number of the hottest keys whose elements are pinned in the purely local region before the queries,
+    //! if the container supports it (see `pin`)
+    size_t n_pinned = 0;
+
+    //! the number of the operations in the churn phase between the construction and the queries, 0 to skip it
+    size_t churn_iterations = 0;
+    //! the relative proportions of insertions of new keys and erasures of existing keys in the churn phase
+    double churn_insert_proportion = 0.5;
+    double churn_erase_proportion = 0.5;
+
+    //! the file into which the accesses of the queries are traced instead of running them, if not empty (see `trace_workload`)
+    std::string trace_path;
+
+    //! @param preset one of 'A' to 'F', as the core workloads of YCSB
+    inline static Workload ycsb(char preset);
+    //! parses comma-separated `name=value` pairs, e.g., "ycsb=B,skew=1.3,n_elements=1000000"
+    //! The `ycsb` preset is applied first regardless of its position.
+    //! If any proportion is given, the proportions not given are 0.
+    //! @throw std::invalid_argument
+    inline static Workload parse(std::string_view spec);
+    //! @throw std::invalid_argument
+    inline void validate() const;
+
+    double total_proportion() const
+    {
+        return read_proportion + scan_proportion + update_proportion + insert_proportion + read_modify_write_proportion + erase_proportion;
+    }
+    //! the ratio of the operations writing mapped values, reported as "UpdateRatio"
+    double update_ratio() const { return (update_proportion + read_modify_write_proportion) / total_proportion(); }
+    bool writes_values() const { return update_proportion > 0 || read_modify_write_proportion > 0; }
+    bool modifies_structure() const { return insert_proportion > 0 || erase_proportion > 0; }
+    //! whether the operations are either point reads or range reads, and updates, as those of the original benchmark
+    //! The key of each operation is drawn before the operation as in the original benchmark, so that the default workload runs the same queries.
+    bool draws_key_first() const
+    {
+        return (read_proportion > 0) != (scan_proportion > 0) && insert_proportion == 0 && read_modify_write_proportion == 0 && erase_proportion == 0;
+    }
+
+    //! the workload of the churn phase, which draws the keys to erase as `*this` draws the keys to read
+    Workload churn() const
+    {
+        Workload res = *this;
+        res.n_iterations = churn_iterations;
+        res.read_proportion = res.scan_proportion = res.update_proportion = res.read_modify_write_proportion = 0.0;
+        res.insert_proportion = churn_insert_proportion;
+        res.erase_proportion = churn_erase_proportion;
+        res.churn_iterations = 0;
+        res.finger_search = false;
+        return res;
+    }
+
+    //! prints the parameters as a comment line, which can be passed to `parse` as it is after "#workload\t"
+    inline void print(std::ostream& os) const;
+};
+
+Workload Workload::ycsb(char preset)
+{
+    Workload res;
+    res.zipf_skewness = 0.99;
+    res.read_proportion = res.scan_proportion = res.update_proportion = 0.0;
+    switch (preset) {
+    case 'A':
+        res.read_proportion = 0.5;
+        res.update_proportion = 0.5;
+        break;
+    case 'B':
+        res.read_proportion = 0.95;
+        res.update_proportion = 0.05;
+        break;
+    case 'C':
+        res.read_proportion = 1.0;
+        break;
+    case 'D':
+        res.key_distribution = KeyDistribution::Latest;
+        res.read_proportion = 0.95;
+        res.insert_proportion = 0.05;
+        break;
+    case 'E':
+        res.scan_proportion = 0.95;
+        res.insert_proportion = 0.05;
+        break;
+    case 'F':
+        res.read_proportion = 0.5;
+        res.read_modify_write_proportion = 0.5;
+        break;
+    default:
+        throw std::invalid_argument{"unknown YCSB workload: " + std::string{preset}};
+    }
+    return res;
+}
+
+Workload Workload::parse(std::string_view spec)
+{
+    const auto fail = [](std::string_view what) {
+        throw std::invalid_argument{"wrong workload parameter: " + std::string{what}};
+    };
+    const auto to_number = [&fail](std::string_view name, std::string_view value, auto& out) {
+        std::istringstream sstr{std::string{value}};
+        sstr >> out;
+        if (sstr.fail() || !sstr.eof()) {
+            fail(std::string{name} + "=" + std::string{value});
+        }
+    };
+
+    std::vector<std::pair<std::string_view, std::string_view>> params;
+    while (!spec.empty()) {
+        const auto comma = spec.find(',');
+        const auto param = spec.substr(0, comma);
+        spec = comma == std::string_view::npos ? std::string_view{} : spec.substr(comma + 1);
+        if (param.empty()) {
+            continue;
+        }
+        const auto equal = param.find('=');
+        if (equal == std::string_view::npos) {
+            fail(param);
+        }
+        params.emplace_back(param.substr(0, equal), param.substr(equal + 1));
+    }
+
+    Workload res;
+    for (const auto& [name, value] : params) {
+        if (name == "ycsb") {
+            if (value.size() != 1) {
+                fail(value);
+            }
+            res = ycsb(value.front());
+        }
+    }
+    const bool proportion_given = std::ranges::any_of(params, [](const auto& param) {
+        return param.first == "read" || param.first == "scan" || param.first == "update"
+               || param.first == "insert" || param.first == "rmw" || param.first == "erase";
+    });
+    if (proportion_given) {
+        res.read_proportion = res.scan_proportion = res.update_proportion = 0.0;
+        res.insert_proportion = res.read_modify_write_proportion = res.erase_proportion = 0.0;
+    }
+
+    for (const auto& [name, value] : params) {
+        if (name == "ycsb") {
+            continue;
+        } else if (name == "n_elements") {
+            to_number(name, value, res.n_elements);
+        } else if (name == "n_iterations") {
+            to_number(name, value, res.n_iterations);
+        } else if (name == "distribution") {
+            if (value == "zipfian") {
+                res.key_distribution = KeyDistribution::Zipfian;
+            } else if (value == "uniform") {
+                res.key_distribution = KeyDistribution::Uniform;
+            } else if (value == "latest") {
+                res.key_distribution = KeyDistribution::Latest;
+            } else {
+                fail(value);
+            }
+        } else if (name == "skew") {
+            to_number(name, value, res.zipf_skewness);
+        } else if (name == "read") {
+            to_number(name, value, res.read_proportion);
+        } else if (name == "scan") {
+            to_number(name, value, res.scan_proportion);
+        } else if (name == "update") {
+            to_number(name, value, res.update_proportion);
+        } else if (name == "insert") {
+            to_number(name, value, res.insert_proportion);
+        } else if (name == "rmw") {
+            to_number(name, value, res.read_modify_write_proportion);
+        } else if (name == "erase") {
+            to_number(name, value, res.erase_proportion);
+        } else if (name == "range") {
+            if (value == "uniform") {
+                res.range_length_distribution = RangeLengthDistribution::Uniform;
+            } else if (value == "constant") {
+                res.range_length_distribution = RangeLengthDistribution::Constant;
+            } else {
+                fail(value);
+            }
+        } else if (name == "max_range_length") {
+            to_number(name, value, res.max_range_length);
+        } else if (name == "batch") {
+            to_number(name, value, res.read_batch);
+        } else if (name == "finger") {
+            to_number(name, value, res.finger_search);
+        } else if (name == "prefetch") {
+            to_number(name, value, res.scan_prefetch);
+        } else if (name == "promote") {
+            to_number(name, value, res.promotion_period);
+        } else if (name == "pin") {
+            to_number(name, value, res.n_pinned);
+        } else if (name == "churn") {
+            to_number(name, value, res.churn_iterations);
+        } else if (name == "churn_insert") {
+            to_number(name, value, res.churn_insert_proportion);
+        } else if (name == "churn_erase") {
+            to_number(name, value, res.churn_erase_proportion);
+        } else if (name == "trace") {
+            res.trace_path = value;
+        } else {
+            fail(name);
+        }
+    }
+
+    res.validate();
+    return res;
+}
+
+void Workload::validate() const
+{
+    if (n_elements == 0 || n_iterations == 0) {
+        throw std::invalid_argument{"workload: n_elements and n_iterations must be positive"};
+    }
+    if (key_distribution != KeyDistribution::Uniform && !(zipf_skewness > 0)) {
+        throw std::invalid_argument{"workload: skew must be positive"};
+    }
+    for (const auto proportion : {read_proportion, scan_proportion, update_proportion, insert_proportion, read_modify_write_proportion, erase_proportion}) {
+        if (!(proportion >= 0)) {
+            throw std::invalid_argument{"workload: proportions must not be negative"};
+        }
+    }
+    if (!(total_proportion() > 0)) {
+        throw std::invalid_argument{"workload: no operation is given"};
+    }
+    if (max_range_length == 0 || max_range_length > MaxRangeLength) {
+        throw std::invalid_argument{"workload: max_range_length must be in [1, " + std::to_string(MaxRangeLength) + "]"};
+    }
+    if (read_batch == 0) {
+        throw std::invalid_argument{"workload: batch must be positive"};
+    }
+    if (finger_search && modifies_structure()) {
+        throw std::invalid_argument{"workload: finger cannot be used with insertions or erasures"};
+    }
+    if (finger_search && promotion_period != 0) {
+        throw std::invalid_argument{"workload: finger cannot be used with promote, which relocates the nodes found"};
+    }
+    if (churn_iterations != 0 && !(churn_insert_proportion >= 0 && churn_erase_proportion >= 0 && churn_insert_proportion + churn_erase_proportion > 0)) {
+        throw std::invalid_argument{"workload: wrong proportions of the churn phase"};
+    }
+    if (!trace_path.empty() && (modifies_structure() || churn_iterations != 0 || promotion_period != 0)) {
+        throw std::invalid_argument{"workload: trace cannot be used with insertions, erasures, churn, or promote, which change the nodes"};
+    }
+}
+
+void Workload::print(std::ostream& os) const
+{
+    constexpr std::array key_distribution_names{"zipfian", "uniform", "latest"};
+    constexpr std::array range_length_distribution_names{"uniform", "constant"};
+
+    os << "#workload\t"
+       << "n_elements=" << n_elements
+       << ",n_iterations=" << n_iterations
+       << ",distribution=" << key_distribution_names[static_cast<size_t>(key_distribution)]
+       << ",skew=" << zipf_skewness
+       << ",read=" << read_proportion
+       << ",scan=" << scan_proportion
+       << ",update=" << update_proportion
+       << ",insert=" << insert_proportion
+       << ",rmw=" << read_modify_write_proportion
+       << ",erase=" << erase_proportion
+       << ",range=" << range_length_distribution_names[static_cast<size_t>(range_length_distribution)]
+       << ",max_range_length=" << max_range_length
+       << ",batch=" << read_batch
+       << ",finger=" << finger_search
+       << ",prefetch=" << scan_prefetch
+       << ",promote=" << promotion_period
+       << ",pin=" << n_pinned
+       << ",churn=" << churn_iterations
+       << ",churn_insert=" << churn_insert_proportion
+       << ",churn_erase=" << churn_erase_proportion;
+    if (!trace_path.empty()) {
+        os << ",trace=" << trace_path;
+    }
+    os << std::endl;
+}
+
+//! the keys in the container while workloads run, shared by all the threads and by the churn and query phases
+//! The key of id i is `FNV_hash(i)`, and the ids [0, n_elements) are inserted by the construction.
+//! If the workloads may insert or erase keys, the ids are ranked in `ranked_ids`, which costs 8 bytes per key in (non-far) memory:
+//! an inserted id is ranked last, and an erased one is replaced with the last ranked.
+//! Otherwise, the rank of an id is the id itself.
+struct KeySpace {
+    //! the id of the next key to insert
+    uint64_t next_id;
+    std::vector<uint64_t> ranked_ids;
+    const bool tracked;
+    //! serializes the insertions and erasures against the other operations in the multi-threaded queries
+    std::shared_mutex structure_mutex;
+
+    explicit KeySpace(const Workload& workload)
+        : next_id(workload.n_elements), tracked(workload.modifies_structure() || workload.churn_iterations != 0)
+    {
+        if (tracked) {
+            ranked_ids.resize(workload.n_elements);
+            std::iota(ranked_ids.begin(), ranked_ids.end(), uint64_t{0});
+        }
+    }
+
+    uint64_t size() const { return tracked ? ranked_ids.size() : next_id; }
+    uint64_t id(uint64_t rank) const { return tracked ? ranked_ids[rank] : rank; }
+};
+
+//! draws the operations of a workload; each thread has its own copy
+//! The keys must be drawn under `KeySpace::structure_mutex` if the other threads may insert or erase keys.
+class WorkloadGenerator
+{
+public:
+    enum Operation : int {
+        PointRead,
+        Scan,
+        PointUpdate,
+        Insertion,
+        ReadModification,
+        Erasure
+    };
+
+    WorkloadGenerator(const Workload& workload, KeySpace& key_space)
+        : workload_(&workload), key_space(&key_space),
+          operation_distribution{workload.read_proportion, workload.scan_proportion, workload.update_proportion,
+              workload.insert_proportion, workload.read_modify_write_proportion, workload.erase_proportion},
+          update_distribution{workload.update_ratio()},
+          range_length_distribution{1, workload.max_range_length}
+    {
+    }
+
+    const Workload& workload() const { return *workload_; }
+    KeySpace& keys() const { return *key_space; }
+
+    template <class URBG>
+    Operation operation(URBG& g)
+    {
+        if (workload_->draws_key_first()) {
+            // the key, and then whether to update it
+            key_drawn_first = key(g);
+            return update_distribution(g) ? PointUpdate : (workload_->read_proportion > 0 ? PointRead : Scan);
+        }
+        return static_cast<Operation>(operation_distribution(g));
+    }
+    //! a key in the container, or one never inserted if the container is empty
+    //! It is the key drawn by `operation` if any (see `Workload::draws_key_first`).
+    template <class URBG>
+    Key key(URBG& g)
+    {
+        if (key_drawn_first) {
+            const Key res = *key_drawn_first;
+            key_drawn_first.reset();
+            return res;
+        }
+        if (key_space->size() == 0) {
+            return FNV_hash(key_space->next_id);
+        }
+        return FNV_hash(key_space->id(rank(g)));
+    }
+    //! a key to insert, which has never been inserted
+    Key new_key()
+    {
+        const auto id = key_space->next_id++;
+        if (key_space->tracked) {
+            key_space->ranked_ids.push_back(id);
+        }
+        return FNV_hash(id);
+    }
+    //! a key in the container to erase, drawn as `key`
+    template <class URBG>
+    std::optional<Key> erased_key(URBG& g)
+    {
+        if (key_space->size() == 0) {
+            return std::nullopt;
+        }
+        auto& ranked_ids = key_space->ranked_ids;
+        const auto r = rank(g);
+        const auto id = ranked_ids[r];
+        ranked_ids[r] = ranked_ids.back();
+        ranked_ids.pop_back();
+        return FNV_hash(id);
+    }
+    template <class URBG>
+    size_t range_length(URBG& g)
+    {
+        if (workload_->range_length_distribution == RangeLengthDistribution::Constant) {
+            return workload_->max_range_length;
+        }
+        return range_length_distribution(g);
+    }
+
+private:
+    const Workload* workload_;
+    KeySpace* key_space;
+    //! rebuilt when the number of the keys has changed
+    std::optional<Zipf_distribution<uint64_t>> zipf;
+    std::discrete_distribution<int> operation_distribution;
+    //! draws whether to update, instead of `operation_distribution`, if `Workload::draws_key_first`
+    std::bernoulli_distribution update_distribution;
+    std::optional<Key> key_drawn_first;
+    std::uniform_int_distribution<size_t> range_length_distribution;
+
+    //! @pre the container is not empty
+    template <class URBG>
+    uint64_t rank(URBG& g)
+    {
+        const auto size = key_space->size();
+        if (workload_->key_distribution == KeyDistribution::Uniform) {
+            return std::uniform_int_distribution<uint64_t>{0, size - 1}(g);
+        }
+        if (!zipf || zipf->n != size) {
+            zipf.emplace(size, workload_->zipf_skewness);
+        }
+        const auto r = (*zipf)(g);
+        return workload_->key_distribution == KeyDistribution::Latest ? size - 1 - r : r;
+    }
+};
+
+//! calls `map.visit_query(key, n_increments, visit)` for each operation of `workload`, and `end_query()` after each operation,
+//! as a single thread runs them in `workload_step`, but only visiting the nodes, i.e., without reading or writing the elements
+//! The keys are drawn from `prng` in the same order as `workload_step`, and each lookup starts at the root even with `finger_search`.
+//! @throw std::invalid_argument if the workload inserts or erases keys
+template <class URBG, class MapType, class Visit, class EndQuery>
+inline void visit_workload(URBG& prng, MapType& map, const Workload& workload, KeySpace& key_space, Visit&& visit, EndQuery&& end_query)
+{
+    if (workload.modifies_structure()) {
+        throw std::invalid_argument{"workload: insertions and erasures cannot be visited"};
+    }
+    WorkloadGenerator generator{workload, key_space};
+
+    for (auto i = workload.n_iterations; i != 0; i--) {
+        switch (generator.operation(prng)) {
+        case WorkloadGenerator::PointRead:
+            for (size_t j = 0; j != workload.read_batch; j++) {
+                map.visit_query(generator.key(prng), 0, visit);
+            }
+            break;
+
+        case WorkloadGenerator::Scan: {
+            const auto key = generator.key(prng);
+            // The range read increments the iterator after each of the elements read.
+            map.visit_query(key, generator.range_length(prng), visit);
+            break;
+        }
+
+        case WorkloadGenerator::PointUpdate:
+        case WorkloadGenerator::ReadModification:
+        default:
+            // the new value, drawn as in `workload_step` before `key`,
+            // which returns the key drawn by `operation` instead if `Workload::draws_key_first`
+            random_bytes(prng);
+            map.visit_query(generator.key(prng), 0, visit);
+            break;
+        }
+        end_query();
+    }
+}
+
+//! counts the links between the objects followed by the queries of `workload`, weighted by how many times they are followed,
+//! as `analyze_edges()` of the containers counts each link once: [purely_local_edges, same_page_edges, diff_pages_edges]
+//! Each move of a query from an object to the next one it visits (see `visit_workload`) is a link followed,
+//! which is purely local if both of the objects are in the purely local region.
+template <size_t PageAlign, class URBG, class MapType>
+inline std::array<size_t, 3> analyze_edges_in_workload(URBG& prng, MapType& map, const Workload& workload)
+{
+    KeySpace key_space{workload};
+    std::array<size_t, 3> acc{};
+    std::optional<std::pair<uintptr_t, bool>> prev;
+
+    const auto visit = [&](const void* address, bool is_local) {
+        const auto cur = reinterpret_cast<uintptr_t>(address);
+        if (prev) {
+            const auto& [prev_address, is_prev_local] = *prev;
+            if (is_prev_local && is_local) {
+                acc[0] += 1;
+            } else {
+                acc[prev_address / PageAlign != cur / PageAlign ? 2 : 1] += 1;
+            }
+        }
+        prev.emplace(cur, is_local);
+    };
+    visit_workload(prng, map, workload, key_space, visit, [&] { prev.reset(); });
+    return acc;
+}
@@ -4,14 +4,26 @@ cd $(dirname $0)/..
 
 function exit_with_help {
     cat <<__EOS__ >&2
-Usage: $(basename $0) STRUCTURE OBJ_PLMT
+Usage: $(basename $0) STRUCTURE OBJ_PLMT [ZIPF_SKEWNESS UPDATE_RATIO]
 
 Parameters
     STRUCTURE:  one of {btree, skiplist}
     OBJ_PLMT:   when STRUCTURE is btree, one of {hint, local, local+dfs, dfs,
-                                                 local+veb, veb}
+                                                 local+veb, veb, local+idfs,
+                                                 local+iveb, local+bdfs, bdfs,
+                                                 local+bveb, bveb, local+mveb}
                 when STRUCTURE is skiplist, one of {hint, local, local+page,
-                                                    page}
+                                                    page, bhint, local+bpage,
+                                                    bpage, hveb, local+veb, veb}
+    ZIPF_SKEWNESS:  if given with UPDATE_RATIO, the links are counted as many
+                    times as the queries of the workload follow them, instead of
+                    once each; positive real number
+    UPDATE_RATIO:   real number in [0, 1]; the other queries are range reads
+
+Environment variables
+    SWAP_UNIT:      the size of the pages in which the nodes are placed in KiB,
+                    one of {4, 64, 2048} (4 by default); the links between them
+                    are cross-page
 __EOS__
     exit 1
 }
@@ -20,14 +32,15 @@ __EOS__
 ##########
 # argument handling
 ##########
-if [[ $# -ne 2 ]]; then
+if [[ $# -ne 2 && $# -ne 4 ]]; then
     exit_with_help
 fi
 
 NumElements=13421773
 total_data_size=$((160 * ${NumElements}))
 local_memory_cap=$((${total_data_size} * 50 / 100))
-purely_local_cap_if_used=$((${local_memory_cap} - ${local_memory_cap} / 4096 / 2 * 4096))
+swap_unit_size=$((${SWAP_UNIT:-4} * 1024))
+purely_local_cap_if_used=$((${local_memory_cap} - ${local_memory_cap} / ${swap_unit_size} / 2 * ${swap_unit_size}))
 
 structure=""
 case "$1" in
@@ -52,6 +65,13 @@ if [[ $structure = "b_tree" ]]; then
         dfs)        obj_plmt="page_aware";                  exec_args="1";;
         local+veb)  obj_plmt="collective_allocator_aware";  exec_args="$purely_local_cap_if_used 2";;
         veb)        obj_plmt="page_aware";                  exec_args="2";;
+        local+idfs) obj_plmt="collective_allocator_aware";  exec_args="$purely_local_cap_if_used 3";;
+        local+iveb) obj_plmt="collective_allocator_aware";  exec_args="$purely_local_cap_if_used 4";;
+        local+bdfs) obj_plmt="collective_allocator_aware";  exec_args="$purely_local_cap_if_used 5";;
+        bdfs)       obj_plmt="page_aware";                  exec_args="5";;
+        local+bveb) obj_plmt="collective_allocator_aware";  exec_args="$purely_local_cap_if_used 6";;
+        bveb)       obj_plmt="page_aware";                  exec_args="6";;
+        local+mveb) obj_plmt="collective_allocator_aware";  exec_args="$purely_local_cap_if_used 7";;
         *)
             cat <<__EOS__ >&2
 error: undefined OBJ_PLMT
@@ -63,10 +83,16 @@ __EOS__
 fi
 if [[ $structure = "skiplist" ]]; then
     case "$2" in
-        hint)       obj_plmt="hinted";                      exec_args="";;
+        hint)       obj_plmt="hinted";                      exec_args="1";;
         local)      obj_plmt="collective_allocator_aware";  exec_args="$purely_local_cap_if_used 0";;
         local+page) obj_plmt="collective_allocator_aware";  exec_args="$purely_local_cap_if_used 1";;
-        page)       obj_plmt="page_aware";                  exec_args="";;
+        page)       obj_plmt="page_aware";                  exec_args="1";;
+        bhint)      obj_plmt="hinted";                      exec_args="5";;
+        local+bpage) obj_plmt="collective_allocator_aware"; exec_args="$purely_local_cap_if_used 5";;
+        bpage)      obj_plmt="page_aware";                  exec_args="5";;
+        hveb)       obj_plmt="hinted";                      exec_args="2";;
+        local+veb)  obj_plmt="collective_allocator_aware";  exec_args="$purely_local_cap_if_used 2";;
+        veb)        obj_plmt="page_aware";                  exec_args="2";;
         *)
             cat <<__EOS__ >&2
 error: undefined OBJ_PLMT
@@ -78,12 +104,48 @@ __EOS__
 fi
 
 
+analysis="analyze_edges"
+workload=""
+if [[ $# -eq 4 ]]; then
+    if [[ ! "$3" =~ ^[0-9]*\.?[0-9]+$ || "$3" =~ ^0*\.?0*$ ]]; then
+            cat <<__EOS__ >&2
+error: wrong ZIPF_SKEWNESS
+
+__EOS__
+            exit_with_help
+    fi
+    if [[ ! "$4" =~ ^[0-9]*\.?[0-9]+$ ]] || awk "BEGIN { exit !($4 > 1) }"; then
+            cat <<__EOS__ >&2
+error: wrong UPDATE_RATIO
+
+__EOS__
+            exit_with_help
+    fi
+    analysis="analyze_query_edges"
+    workload="skew=$3,update=$4,scan=$(awk "BEGIN { print 1 - $4 }")"
+fi
+
+
 ##########
 # run the benchmark
 ##########
-log_name="logs/analyze_edges_of_$2_$1.log"
+program="./build/analyze_edges_of_${obj_plmt}_${structure}"
+log_suffix=""
+if [[ ${SWAP_UNIT:-4} != 4 ]]; then
+    if [[ ! -x "${program}_${SWAP_UNIT}KiB" ]]; then
+            cat <<__EOS__ >&2
+error: no program for SWAP_UNIT=${SWAP_UNIT}
+
+__EOS__
+            exit_with_help
+    fi
+    program="${program}_${SWAP_UNIT}KiB"
+    log_suffix="_${SWAP_UNIT}KiB"
+fi
+
+log_name="logs/${analysis}_of_$2_$1${log_suffix}.log"
 mkdir -p logs
 echo "log file: ${log_name}"
 
-echo "###analyze_edges_of_$2_$1###" | tee -a ${log_name}
-./build/analyze_edges_of_${obj_plmt}_${structure} $exec_args | tee -a ${log_name}
+echo "###${analysis}_of_$2_$1${log_suffix}###" | tee -a ${log_name}
+${program} $exec_args $workload | tee -a ${log_name}
@@ -0,0 +1,70 @@
+#!/bin/bash
+cd $(dirname $0)
+
+
+function exit_with_help {
+    cat <<__EOS__ >&2
+Usage: $(basename $0) [LOCAL_MEM_CAP ZIPF_SKEWNESS UPDATE_RATIO]
+
+Runs kvs_benchmark.sh for the B-tree with each maximum number of the elements
+in a node (MAX_N_ELEMS) and each placement, and summarizes the results.
+The B-trees of 8, 16, and 24 elements in the purely local region are also run
+searching the keys by SIMD (SEPARATE_KEYS=1), whose placements are suffixed
+by "+sk" in the summary.
+The parameters are those of kvs_benchmark.sh (200 1.3 0.05 by default).
+__EOS__
+    exit 1
+}
+
+if [[ $# -ne 0 && $# -ne 3 ]]; then
+    exit_with_help
+fi
+L=${1:-200}
+alpha=${2:-1.3}
+U=${3:-0.05}
+
+for max_n_elems in 2 4 8 16 24
+do
+  for plmt in hint local local+dfs dfs local+veb veb
+  do
+    MAX_N_ELEMS=$max_n_elems ./kvs_benchmark.sh btree $plmt $L $alpha $U > /dev/null || exit 1
+  done
+done
+for max_n_elems in 8 16 24
+do
+  for plmt in local local+dfs local+veb
+  do
+    MAX_N_ELEMS=$max_n_elems SEPARATE_KEYS=1 ./kvs_benchmark.sh btree $plmt $L $alpha $U > /dev/null || exit 1
+  done
+done
+
+
+##########
+# summary of the last result of each program, picked from the log by the column names
+##########
+echo -e "placement\tMaxNElems\theight\tconstruction_duration[ns]\tquery_duration[ns]\tquery_read_cnt\tquery_write_cnt"
+for max_n_elems in 2 4 8 16 24
+do
+  log_suffix=$([[ $max_n_elems != 2 ]] && echo "_${max_n_elems}")
+  for plmt in hint local local+dfs dfs local+veb veb
+  do
+    awk -F '\t' -v plmt=$plmt '
+      /^#NumElements/ { for (i = 1; i <= NF; i++) col[$i] = i; getline; row = $0 }
+      END {
+        split(row, v, "\t")
+        print plmt "\t" v[col["MaxNElems"]] "\t" v[col["height"]] "\t" v[col["construction_duration[ns]"]] "\t" v[col["query_duration[ns]"]] "\t" v[col["query_read_cnt"]] "\t" v[col["query_write_cnt"]]
+      }' ../logs/kvs_benchmark_with_${plmt}_btree${log_suffix}.log
+  done
+done
+for max_n_elems in 8 16 24
+do
+  for plmt in local local+dfs local+veb
+  do
+    awk -F '\t' -v plmt=$plmt+sk '
+      /^#NumElements/ { for (i = 1; i <= NF; i++) col[$i] = i; getline; row = $0 }
+      END {
+        split(row, v, "\t")
+        print plmt "\t" v[col["MaxNElems"]] "\t" v[col["height"]] "\t" v[col["construction_duration[ns]"]] "\t" v[col["query_duration[ns]"]] "\t" v[col["query_read_cnt"]] "\t" v[col["query_write_cnt"]]
+      }' ../logs/kvs_benchmark_with_${plmt}_btree_${max_n_elems}_separate_keys.log
+  done
+done
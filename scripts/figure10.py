@@ -23,15 +23,17 @@ def main():
     dtype = [("NumElements", np.int64), ("NIteration", np.int64), ("ZipfSkewness", np.float64), ("UpdateRatio", np.float64),
              ("PurelyLocalCapacity", np.int64), ("UMAP_BUFSIZE",
                                                  np.int64), ("batch_blocking", np.int64),
-             ("construction_duration", np.int64), ("query_duration", np.int64), ("query_read_cnt", np.int64), ("query_write_cnt", np.int64)]
+             ("construction_duration", np.int64), ("query_duration", np.int64), ("query_read_cnt", np.int64), ("query_write_cnt", np.int64),
+             ("NThreads", np.int64), ("query_throughput", np.float64), ("query_mean_latency", np.int64), ("query_max_latency", np.int64),
+             ("query_p50_latency", np.int64), ("query_p99_latency", np.int64), ("query_p999_latency", np.int64)]
 
     variants = {}
-    variants["dfs"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_dfs_btree.log"), dtype=dtype, ndmin=2)
-    variants["vEB"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_veb_btree.log"), dtype=dtype, ndmin=2)
-    variants["local"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_local_btree.log"), dtype=dtype, ndmin=2)
-    variants["local+dfs"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_local+dfs_btree.log"), dtype=dtype, ndmin=2)
-    variants["local+vEB"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_local+veb_btree.log"), dtype=dtype, ndmin=2)
-    variants["hint"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_hint_btree.log"), dtype=dtype, ndmin=2)
+    variants["dfs"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_dfs_btree.log"), dtype=dtype, usecols=range(len(dtype)), ndmin=2)
+    variants["vEB"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_veb_btree.log"), dtype=dtype, usecols=range(len(dtype)), ndmin=2)
+    variants["local"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_local_btree.log"), dtype=dtype, usecols=range(len(dtype)), ndmin=2)
+    variants["local+dfs"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_local+dfs_btree.log"), dtype=dtype, usecols=range(len(dtype)), ndmin=2)
+    variants["local+vEB"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_local+veb_btree.log"), dtype=dtype, usecols=range(len(dtype)), ndmin=2)
+    variants["hint"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_hint_btree.log"), dtype=dtype, usecols=range(len(dtype)), ndmin=2)
 
     for variant, color, marker in zip(variants.keys(), colors, markers):
         used_local_buf = (variants[variant]["PurelyLocalCapacity"] + variants[variant]["UMAP_BUFSIZE"] * 4096) \
@@ -44,13 +46,18 @@ def main():
         tmp.sort(order="used_local_buf")
         variants[variant] = dict(data=tmp, color=color, marker=marker)
 
-    def create_figure(variants, subfigures, create_legend=False):
+    # (field, label of y-axis, suffix of file name)
+    swap_metric = ("query_swap_cnt", r"amount of swapped data", "")
+    tail_latency_metric = ("query_p99_latency", r"99%ile latency [ns]", "_p99")
+
+    def create_figure(variants, subfigures, create_legend=False, metric=swap_metric):
+        field, ylabel, file_suffix = metric
         subfig_suffix_iter = iter(subfigures)
         for zipf_skewness, update_ratio in ((0.8, 0.05), (0.8, 0.5), (1.3, 0.05), (1.3, 0.5)):
             fig = plt.figure(figsize=(2.55, 1.3))
             ax = fig.add_subplot(1, 1, 1)
             ax.set_xlabel(r"$L =$(local memory usage)/(data size) [%]")
-            ax.set_ylabel(r"amount of swapped data")
+            ax.set_ylabel(ylabel)
             ax.yaxis.set_major_formatter(ticker.ScalarFormatter(useMathText=True))
             ax.ticklabel_format(style="sci", axis="y", scilimits=(0, 0))
 
@@ -68,7 +75,7 @@ def main():
                 labels.append(label)
                 lines.append(ax.plot(
                     datum["used_local_buf"],
-                    datum["query_swap_cnt"],
+                    datum[field],
                     color=variant["color"],
                     marker=variant["marker"]
                 )[0])
@@ -82,7 +89,7 @@ def main():
 
             fig.savefig(
                 os.path.join(
-                    os.path.dirname(__file__), f"../charts/figure10{next(subfig_suffix_iter)}.pdf"
+                    os.path.dirname(__file__), f"../charts/figure10{next(subfig_suffix_iter)}{file_suffix}.pdf"
                 ),
                 bbox_inches="tight",
             )
@@ -100,6 +107,8 @@ def main():
     create_figure(variants, "abcd", create_legend=True)
     create_figure({k: variants[k] for k in ["dfs", "local", "local+dfs", "hint"]}, subfigures="abcd")
     create_figure({k: variants[k] for k in ["dfs", "vEB", "local+dfs", "local+vEB"]}, subfigures="efgh")
+    create_figure({k: variants[k] for k in ["dfs", "local", "local+dfs", "hint"]}, subfigures="abcd", metric=tail_latency_metric)
+    create_figure({k: variants[k] for k in ["dfs", "vEB", "local+dfs", "local+vEB"]}, subfigures="efgh", metric=tail_latency_metric)
 
 
 if __name__ == "__main__":
@@ -24,13 +24,15 @@ def main():
     dtype = [("NumElements", np.int64), ("NIteration", np.int64), ("ZipfSkewness", np.float64), ("UpdateRatio", np.float64),
              ("PurelyLocalCapacity", np.int64), ("UMAP_BUFSIZE",
                                                  np.int64), ("batch_blocking", np.int64),
-             ("construction_duration", np.int64), ("query_duration", np.int64), ("query_read_cnt", np.int64), ("query_write_cnt", np.int64)]
+             ("construction_duration", np.int64), ("query_duration", np.int64), ("query_read_cnt", np.int64), ("query_write_cnt", np.int64),
+             ("NThreads", np.int64), ("query_throughput", np.float64), ("query_mean_latency", np.int64), ("query_max_latency", np.int64),
+             ("query_p50_latency", np.int64), ("query_p99_latency", np.int64), ("query_p999_latency", np.int64)]
 
     data = {}
-    data["page"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_page_skiplist.log"), dtype=dtype, ndmin=2)
-    data["local"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_local_skiplist.log"), dtype=dtype, ndmin=2)
-    data["local+page"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_local+page_skiplist.log"), dtype=dtype, ndmin=2)
-    data["hint"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_hint_skiplist.log"), dtype=dtype, ndmin=2)
+    data["page"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_page_skiplist.log"), dtype=dtype, usecols=range(len(dtype)), ndmin=2)
+    data["local"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_local_skiplist.log"), dtype=dtype, usecols=range(len(dtype)), ndmin=2)
+    data["local+page"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_local+page_skiplist.log"), dtype=dtype, usecols=range(len(dtype)), ndmin=2)
+    data["hint"] = np.loadtxt(os.path.join(log_dir, "kvs_benchmark_with_hint_skiplist.log"), dtype=dtype, usecols=range(len(dtype)), ndmin=2)
 
     for variant in data.keys():
         used_local_buf = (data[variant]["PurelyLocalCapacity"] + data[variant]["UMAP_BUFSIZE"]
@@ -42,50 +44,53 @@ def main():
         tmp.sort(order="used_local_buf")
         data[variant] = tmp
 
-    for zipf_skewness, update_ratio, subfigure_idx in ((0.8, 0.05, "a"), (0.8, 0.5, "b"), (1.3, 0.05, "c"), (1.3, 0.5, "d")):
-        fig = plt.figure(figsize=(2.55, 1))
-        ax = fig.add_subplot(1, 1, 1)
-        ax.set_xlabel(r"$L =$(local memory usage)/(data size) [%]")
-        ax.set_ylabel(r"amount of swapped data")
-        ax.yaxis.set_major_formatter(ticker.ScalarFormatter(useMathText=True))
-        ax.ticklabel_format(style="sci", axis="y", scilimits=(0, 0))
-
-        legendfig = plt.figure()
-        lines = []
-        labels = []
-
-        ax.axvline(100, color="black", linestyle="dashed")
-
-        for variant in data:
-            datum = data[variant][(data[variant]["ZipfSkewness"] == zipf_skewness) & (
-                data[variant]["UpdateRatio"] == update_ratio)]
-            lines.append(ax.plot(
-                datum["used_local_buf"],
-                datum["query_swap_cnt"]
-            ))
-            labels.append(variant)
-
-        x_max = np.max([data[variant]["used_local_buf"][-1] for variant in data])
-        ax.set_xlim((0, x_max))
-        ax.set_xticks(tuple(x_max * i // 8 for i in range(9)))
-
-        (bottom, top) = ax.get_ylim()
-        ax.set_ylim((0.0, top))
-
-        fig.savefig(
-            os.path.join(
-                os.path.dirname(__file__), f"../charts/figure11{subfigure_idx}.pdf"
-            ),
-            bbox_inches="tight",
-        )
-
-        legendfig.legend(map(lambda x: x[0], lines), labels, ncol=4).get_frame().set_alpha(1.0)
-        legendfig.savefig(
-            os.path.join(
-                os.path.dirname(__file__), f"../charts/figure11_legend.pdf"
-            ),
-            bbox_inches="tight",
-        )
+    # (field, label of y-axis, suffix of file name)
+    for field, ylabel, file_suffix in (("query_swap_cnt", r"amount of swapped data", ""),
+                                       ("query_p99_latency", r"99%ile latency [ns]", "_p99")):
+        for zipf_skewness, update_ratio, subfigure_idx in ((0.8, 0.05, "a"), (0.8, 0.5, "b"), (1.3, 0.05, "c"), (1.3, 0.5, "d")):
+            fig = plt.figure(figsize=(2.55, 1))
+            ax = fig.add_subplot(1, 1, 1)
+            ax.set_xlabel(r"$L =$(local memory usage)/(data size) [%]")
+            ax.set_ylabel(ylabel)
+            ax.yaxis.set_major_formatter(ticker.ScalarFormatter(useMathText=True))
+            ax.ticklabel_format(style="sci", axis="y", scilimits=(0, 0))
+
+            legendfig = plt.figure()
+            lines = []
+            labels = []
+
+            ax.axvline(100, color="black", linestyle="dashed")
+
+            for variant in data:
+                datum = data[variant][(data[variant]["ZipfSkewness"] == zipf_skewness) & (
+                    data[variant]["UpdateRatio"] == update_ratio)]
+                lines.append(ax.plot(
+                    datum["used_local_buf"],
+                    datum[field]
+                ))
+                labels.append(variant)
+
+            x_max = np.max([data[variant]["used_local_buf"][-1] for variant in data])
+            ax.set_xlim((0, x_max))
+            ax.set_xticks(tuple(x_max * i // 8 for i in range(9)))
+
+            (bottom, top) = ax.get_ylim()
+            ax.set_ylim((0.0, top))
+
+            fig.savefig(
+                os.path.join(
+                    os.path.dirname(__file__), f"../charts/figure11{subfigure_idx}{file_suffix}.pdf"
+                ),
+                bbox_inches="tight",
+            )
+
+            legendfig.legend(map(lambda x: x[0], lines), labels, ncol=4).get_frame().set_alpha(1.0)
+            legendfig.savefig(
+                os.path.join(
+                    os.path.dirname(__file__), f"../charts/figure11_legend.pdf"
+                ),
+                bbox_inches="tight",
+            )
 
 
 if __name__ == "__main__":
@@ -1,5 +1,6 @@
 #!/usr/bin/env python3
 import os.path
+import sys
 import colorsys
 import numpy as np
 import matplotlib.pyplot as plt
@@ -22,18 +23,21 @@ def main():
 
     log_dir = os.path.join(os.path.dirname(__file__),
                            "../logs")
+    # with "query", the links followed by the queries, i.e., `analyze_edges.sh STRUCTURE OBJ_PLMT ZIPF_SKEWNESS UPDATE_RATIO`
+    query = len(sys.argv) > 1 and sys.argv[1] == "query"
+    analysis = "analyze_query_edges" if query else "analyze_edges"
 
     dtype = [("NumElements", np.int64), ("PurelyLocalCapacity", np.int64), ("batch_blocking", np.int64),
              ("construction_duration", np.int64), ("purely-local", np.int64), ("in-page", np.int64), ("cross-page", np.int64)]
     edge_types = ("purely-local", "in-page", "cross-page")
 
     plot_data = {}
-    plot_data["dfs"] = np.loadtxt(os.path.join(log_dir, "analyze_edges_of_dfs_btree.log"), dtype=dtype, ndmin=2)
-    plot_data["vEB"] = np.loadtxt(os.path.join(log_dir, "analyze_edges_of_veb_btree.log"), dtype=dtype, ndmin=2)
-    plot_data["local"] = np.loadtxt(os.path.join(log_dir, "analyze_edges_of_local_btree.log"), dtype=dtype, ndmin=2)
-    plot_data["local+dfs"] = np.loadtxt(os.path.join(log_dir, "analyze_edges_of_local+dfs_btree.log"), dtype=dtype, ndmin=2)
-    plot_data["local+vEB"] = np.loadtxt(os.path.join(log_dir, "analyze_edges_of_local+veb_btree.log"), dtype=dtype, ndmin=2)
-    plot_data["hint"] = np.loadtxt(os.path.join(log_dir, "analyze_edges_of_hint_btree.log"), dtype=dtype, ndmin=2)
+    plot_data["dfs"] = np.loadtxt(os.path.join(log_dir, f"{analysis}_of_dfs_btree.log"), dtype=dtype, ndmin=2)
+    plot_data["vEB"] = np.loadtxt(os.path.join(log_dir, f"{analysis}_of_veb_btree.log"), dtype=dtype, ndmin=2)
+    plot_data["local"] = np.loadtxt(os.path.join(log_dir, f"{analysis}_of_local_btree.log"), dtype=dtype, ndmin=2)
+    plot_data["local+dfs"] = np.loadtxt(os.path.join(log_dir, f"{analysis}_of_local+dfs_btree.log"), dtype=dtype, ndmin=2)
+    plot_data["local+vEB"] = np.loadtxt(os.path.join(log_dir, f"{analysis}_of_local+veb_btree.log"), dtype=dtype, ndmin=2)
+    plot_data["hint"] = np.loadtxt(os.path.join(log_dir, f"{analysis}_of_hint_btree.log"), dtype=dtype, ndmin=2)
 
     values = np.concatenate(tuple(plot_data.values()))
     keys = plot_data.keys()
@@ -68,7 +72,7 @@ def main():
     plt.savefig(
         os.path.join(
             os.path.dirname(
-                __file__), f"../charts/figure9a.pdf"
+                __file__), f"../charts/figure9a{'_query' if query else ''}.pdf"
         ),
         bbox_inches="tight",
     )
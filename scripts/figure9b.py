@@ -1,5 +1,6 @@
 #!/usr/bin/env python3
 import os.path
+import sys
 import colorsys
 import numpy as np
 import matplotlib.pyplot as plt
@@ -22,16 +23,19 @@ def main():
 
     log_dir = os.path.join(os.path.dirname(__file__),
                            "../logs")
+    # with "query", the links followed by the queries, i.e., `analyze_edges.sh STRUCTURE OBJ_PLMT ZIPF_SKEWNESS UPDATE_RATIO`
+    query = len(sys.argv) > 1 and sys.argv[1] == "query"
+    analysis = "analyze_query_edges" if query else "analyze_edges"
 
     dtype = [("NumElements", np.int64), ("PurelyLocalCapacity", np.int64), ("batch_blocking", np.int64),
              ("construction_duration", np.int64), ("purely-local", np.int64), ("in-page", np.int64), ("cross-page", np.int64)]
     edge_types = ("purely-local", "in-page", "cross-page")
 
     plot_data = {}
-    plot_data["page"] = np.loadtxt(os.path.join(log_dir, "analyze_edges_of_page_skiplist.log"), dtype=dtype, ndmin=2)
-    plot_data["local"] = np.loadtxt(os.path.join(log_dir, "analyze_edges_of_local_skiplist.log"), dtype=dtype, ndmin=2)
-    plot_data["local+page"] = np.loadtxt(os.path.join(log_dir, "analyze_edges_of_local+page_skiplist.log"), dtype=dtype, ndmin=2)
-    plot_data["hint"] = np.loadtxt(os.path.join(log_dir, "analyze_edges_of_hint_skiplist.log"), dtype=dtype, ndmin=2)
+    plot_data["page"] = np.loadtxt(os.path.join(log_dir, f"{analysis}_of_page_skiplist.log"), dtype=dtype, ndmin=2)
+    plot_data["local"] = np.loadtxt(os.path.join(log_dir, f"{analysis}_of_local_skiplist.log"), dtype=dtype, ndmin=2)
+    plot_data["local+page"] = np.loadtxt(os.path.join(log_dir, f"{analysis}_of_local+page_skiplist.log"), dtype=dtype, ndmin=2)
+    plot_data["hint"] = np.loadtxt(os.path.join(log_dir, f"{analysis}_of_hint_skiplist.log"), dtype=dtype, ndmin=2)
 
     values = np.concatenate(tuple(plot_data.values()))
     keys = plot_data.keys()
@@ -66,7 +70,7 @@ def main():
     plt.savefig(
         os.path.join(
             os.path.dirname(
-                __file__), f"../charts/figure9b.pdf"
+                __file__), f"../charts/figure9b{'_query' if query else ''}.pdf"
         ),
         bbox_inches="tight",
     )
@@ -4,18 +4,45 @@ cd $(dirname $0)/..
 
 function exit_with_help {
     cat <<__EOS__ >&2
-Usage: $(basename $0) STRUCTURE OBJ_PLMT LOCAL_MEM_CAP ZIPF_SKEWNESS UPDATE_RATIO
+Usage: $(basename $0) STRUCTURE OBJ_PLMT LOCAL_MEM_CAP ZIPF_SKEWNESS UPDATE_RATIO [N_THREADS]
 
 Parameters
-    STRUCTURE:      one of {btree, skiplist}
+    STRUCTURE:      one of {btree, skiplist, bptree}
     OBJ_PLMT:       when STRUCTURE is btree, one of {hint, local, local+dfs, dfs,
-                                                     local+veb, veb}
+                                                     local+veb, veb, local+idfs,
+                                                     local+iveb, local+bdfs, bdfs,
+                                                     local+bveb, bveb, local+hot,
+                                                     local+dfs+hot, local+split,
+                                                     local+dfs+split, local+mveb}
                     when STRUCTURE is skiplist, one of {hint, local, local+page,
-                                                        page}
+                                                        page, bhint, local+bpage,
+                                                        bpage, hveb, local+veb, veb}
+                    when STRUCTURE is bptree, one of {local, local+dfs}
     LOCAL_MEM_CAP:  PERSENTAGE (unsignd integer) of local memory usage to the
                     total data size
-    ZIPF_SKEWNESS:  one of {0.8, 1.3}
-    UPDATE_RATIO:   one of {0.05, 0.5}
+    ZIPF_SKEWNESS:  positive real number (0.8 and 1.3 in the paper)
+    UPDATE_RATIO:   real number in [0, 1] (0.05 and 0.5 in the paper); the other
+                    queries are range reads
+    N_THREADS:      the number of query threads (unsigned integer, 1 by default)
+
+Environment variables
+    MAX_N_ELEMS:    when STRUCTURE is btree, the maximum number of the elements in
+                    a node, one of {2, 4, 8, 16, 24} (2 by default); not with
+                    local+split and local+dfs+split
+    SEPARATE_KEYS:  when 1 with MAX_N_ELEMS of 8, 16, or 24, the B-tree of the
+                    placements local* searches the copies of the keys kept in
+                    each node by SIMD (KEY_SEARCH_ISA in CMakeLists.txt); not
+                    with SWAP_UNIT
+    SWAP_UNIT:      the size of the pages in which the nodes are placed and
+                    swapped in KiB, one of {4, 64, 2048} (4 by default); the
+                    programs of 64 and 2048 KiB are not with bptree,
+                    local+split, and local+dfs+split, nor with MAX_N_ELEMS
+    TRACE:          a file into which the program records the trace of the
+                    accesses of the queries instead of running them, which is
+                    then replayed for the page cache of UMAP_BUFSIZE pages; not
+                    with bptree, local+hot, and local+dfs+hot
+    REPLACEMENT:    the replacement policy of the page cache replaying TRACE, one
+                    of {fifo, lru, clock} (fifo by default, as UMap)
 __EOS__
     exit 1
 }
@@ -24,9 +51,10 @@ __EOS__
 ##########
 # argument handling
 ##########
-if [[ $# -ne 5 ]]; then
+if [[ $# -ne 5 && $# -ne 6 ]]; then
     exit_with_help
 fi
+n_threads=${6:-1}
 
 if [[ ! "$3" =~ ^\+?[1-9][0-9]*$ ]]; then
     cat <<__EOS__ >&2
@@ -39,13 +67,15 @@ fi
 num_elements=13421773
 total_data_size=$((160 * ${num_elements}))
 local_memory_cap=$((${total_data_size} * $3 / 100))
-local_memory_cap_in_pages=$((${local_memory_cap} / 4096))
-purely_local_cap_if_used=$((${local_memory_cap} - ${local_memory_cap_in_pages} / 2 * 4096))
+swap_unit_size=$((${SWAP_UNIT:-4} * 1024))
+local_memory_cap_in_pages=$((${local_memory_cap} / ${swap_unit_size}))
+purely_local_cap_if_used=$((${local_memory_cap} - ${local_memory_cap_in_pages} / 2 * ${swap_unit_size}))
 
 # structure=""
 case "$1" in
     btree) structure="b_tree";;
     skiplist) structure="skiplist";;
+    bptree) structure="b_plus_tree";;
     *)
         cat <<__EOS__ >&2
 error: undefined STRUCTURE
@@ -58,6 +88,8 @@ esac
 obj_plmt=""
 exec_args=""
 swap_cache_size=0
+# appended to the workload, e.g., to enable the promotion of hot nodes
+workload_args=""
 if [[ $structure = "b_tree" ]]; then
     case "$2" in
         hint)       obj_plmt="hinted";                      swap_cache_size=$local_memory_cap_in_pages;             exec_args="";;
@@ -66,6 +98,17 @@ if [[ $structure = "b_tree" ]]; then
         dfs)        obj_plmt="page_aware";                  swap_cache_size=$local_memory_cap_in_pages;             exec_args="1";;
         local+veb)  obj_plmt="collective_allocator_aware";  swap_cache_size=$(($local_memory_cap_in_pages / 2));    exec_args="$purely_local_cap_if_used 2";;
         veb)        obj_plmt="page_aware";                  swap_cache_size=$local_memory_cap_in_pages;             exec_args="2";;
+        local+idfs) obj_plmt="collective_allocator_aware";  swap_cache_size=$(($local_memory_cap_in_pages / 2));    exec_args="$purely_local_cap_if_used 3";;
+        local+iveb) obj_plmt="collective_allocator_aware";  swap_cache_size=$(($local_memory_cap_in_pages / 2));    exec_args="$purely_local_cap_if_used 4";;
+        local+bdfs) obj_plmt="collective_allocator_aware";  swap_cache_size=$(($local_memory_cap_in_pages / 2));    exec_args="$purely_local_cap_if_used 5";;
+        bdfs)       obj_plmt="page_aware";                  swap_cache_size=$local_memory_cap_in_pages;             exec_args="5";;
+        local+bveb) obj_plmt="collective_allocator_aware";  swap_cache_size=$(($local_memory_cap_in_pages / 2));    exec_args="$purely_local_cap_if_used 6";;
+        bveb)       obj_plmt="page_aware";                  swap_cache_size=$local_memory_cap_in_pages;             exec_args="6";;
+        local+hot)  obj_plmt="collective_allocator_aware";  swap_cache_size=$(($local_memory_cap_in_pages / 2));    exec_args="$purely_local_cap_if_used 0";  workload_args=",promote=64";;
+        local+dfs+hot) obj_plmt="collective_allocator_aware"; swap_cache_size=$(($local_memory_cap_in_pages / 2));  exec_args="$purely_local_cap_if_used 1";  workload_args=",promote=64";;
+        local+split) obj_plmt="split_values";               swap_cache_size=$(($local_memory_cap_in_pages / 2));    exec_args="$purely_local_cap_if_used 0";;
+        local+dfs+split) obj_plmt="split_values";           swap_cache_size=$(($local_memory_cap_in_pages / 2));    exec_args="$purely_local_cap_if_used 1";;
+        local+mveb) obj_plmt="collective_allocator_aware";  swap_cache_size=$(($local_memory_cap_in_pages / 2));    exec_args="$purely_local_cap_if_used 7";;
         *)
             cat <<__EOS__ >&2
 error: undefined OBJ_PLMT
@@ -77,10 +120,29 @@ __EOS__
 fi
 if [[ $structure = "skiplist" ]]; then
     case "$2" in
-        hint)       obj_plmt="hinted";                      swap_cache_size=$local_memory_cap_in_pages;             exec_args="";;
+        hint)       obj_plmt="hinted";                      swap_cache_size=$local_memory_cap_in_pages;             exec_args="1";;
         local)      obj_plmt="collective_allocator_aware";  swap_cache_size=$(($local_memory_cap_in_pages / 2));    exec_args="$purely_local_cap_if_used 0";;
         local+page) obj_plmt="collective_allocator_aware";  swap_cache_size=$(($local_memory_cap_in_pages / 2));    exec_args="$purely_local_cap_if_used 1";;
-        page)       obj_plmt="page_aware";                  swap_cache_size=$local_memory_cap_in_pages;             exec_args="";;
+        page)       obj_plmt="page_aware";                  swap_cache_size=$local_memory_cap_in_pages;             exec_args="1";;
+        bhint)      obj_plmt="hinted";                      swap_cache_size=$local_memory_cap_in_pages;             exec_args="5";;
+        local+bpage) obj_plmt="collective_allocator_aware"; swap_cache_size=$(($local_memory_cap_in_pages / 2));    exec_args="$purely_local_cap_if_used 5";;
+        bpage)      obj_plmt="page_aware";                  swap_cache_size=$local_memory_cap_in_pages;             exec_args="5";;
+        hveb)       obj_plmt="hinted";                      swap_cache_size=$local_memory_cap_in_pages;             exec_args="2";;
+        local+veb)  obj_plmt="collective_allocator_aware";  swap_cache_size=$(($local_memory_cap_in_pages / 2));    exec_args="$purely_local_cap_if_used 2";;
+        veb)        obj_plmt="page_aware";                  swap_cache_size=$local_memory_cap_in_pages;             exec_args="2";;
+        *)
+            cat <<__EOS__ >&2
+error: undefined OBJ_PLMT
+
+__EOS__
+            exit_with_help
+            ;;
+    esac
+fi
+if [[ $structure = "b_plus_tree" ]]; then
+    case "$2" in
+        local)      obj_plmt="collective_allocator_aware";  swap_cache_size=$(($local_memory_cap_in_pages / 2));    exec_args="$purely_local_cap_if_used 0";;
+        local+dfs)  obj_plmt="collective_allocator_aware";  swap_cache_size=$(($local_memory_cap_in_pages / 2));    exec_args="$purely_local_cap_if_used 1";;
         *)
             cat <<__EOS__ >&2
 error: undefined OBJ_PLMT
@@ -91,30 +153,84 @@ __EOS__
     esac
 fi
 
-if [[ ! ( "$4" = 0.8 || "$4" = 1.3 )]]; then
+if [[ ! "$4" =~ ^[0-9]*\.?[0-9]+$ || "$4" =~ ^0*\.?0*$ ]]; then
             cat <<__EOS__ >&2
 error: wrong ZIPF_SKEWNESS
 
 __EOS__
             exit_with_help
 fi
-if [[ ! ( "$5" = 0.05 || "$5" = 0.5 )]]; then
+if [[ ! "$5" =~ ^[0-9]*\.?[0-9]+$ ]] || awk "BEGIN { exit !($5 > 1) }"; then
             cat <<__EOS__ >&2
 error: wrong UPDATE_RATIO
 
+__EOS__
+            exit_with_help
+fi
+if [[ ! "$n_threads" =~ ^\+?[1-9][0-9]*$ ]]; then
+            cat <<__EOS__ >&2
+error: N_THREADS should be an unsigned integer
+
 __EOS__
             exit_with_help
 fi
 
 
+program="./build/${obj_plmt}_${structure}"
+log_suffix=""
+max_n_elems=${MAX_N_ELEMS:-2}
+if [[ $max_n_elems != 2 ]]; then
+    if [[ $structure != "b_tree" || ! -x "${program}_${max_n_elems}" ]]; then
+            cat <<__EOS__ >&2
+error: no program for MAX_N_ELEMS=${max_n_elems}
+
+__EOS__
+            exit_with_help
+    fi
+    program="${program}_${max_n_elems}"
+    log_suffix="_${max_n_elems}"
+fi
+if [[ ${SEPARATE_KEYS:-0} != 0 ]]; then
+    if [[ ! -x "${program}_separate_keys" ]]; then
+            cat <<__EOS__ >&2
+error: no program for SEPARATE_KEYS=${SEPARATE_KEYS}
+
+__EOS__
+            exit_with_help
+    fi
+    program="${program}_separate_keys"
+    log_suffix="${log_suffix}_separate_keys"
+fi
+if [[ ${SWAP_UNIT:-4} != 4 ]]; then
+    if [[ ! -x "${program}_${SWAP_UNIT}KiB" ]]; then
+            cat <<__EOS__ >&2
+error: no program for SWAP_UNIT=${SWAP_UNIT}
+
+__EOS__
+            exit_with_help
+    fi
+    program="${program}_${SWAP_UNIT}KiB"
+    log_suffix="${log_suffix}_${SWAP_UNIT}KiB"
+fi
+
+
 ##########
 # run the benchmark
 ##########
-log_name="logs/kvs_benchmark_with_$2_$1.log"
+if [[ -n $TRACE ]]; then
+    workload_args="${workload_args},trace=${TRACE}"
+    log_suffix="${log_suffix}_trace"
+fi
+log_name="logs/kvs_benchmark_with_$2_$1${log_suffix}.log"
 mkdir -p logs
 echo "log file: ${log_name}"
 
-echo "###kvs_benchmark_with_$2_$1###" | tee -a ${log_name}
+echo "###kvs_benchmark_with_$2_$1${log_suffix}###" | tee -a ${log_name}
 export UMAP_LOG_LEVEL=ERROR
 export UMAP_BUFSIZE=$swap_cache_size
-./build/${obj_plmt}_${structure}_skew${4}_update${5} $exec_args | tee -a ${log_name}
+export UMAP_PAGESIZE=$swap_unit_size
+workload="skew=$4,update=$5,scan=$(awk "BEGIN { print 1 - $5 }")${workload_args}"
+${program} $exec_args $n_threads $workload | tee -a ${log_name}
+if [[ -n $TRACE ]]; then
+    ./build/replay_trace ${TRACE} ${REPLACEMENT:-fifo} $swap_cache_size | tee -a ${log_name}
+fi
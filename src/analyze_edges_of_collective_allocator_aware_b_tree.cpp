@@ -1,4 +1,5 @@
 #include "setting_basis.hpp"
+#include "workload.hpp"
 
 #include <far_memory_container/blocked/b_tree.hpp>
 #include <farmalloc/collective_allocator.hpp>
@@ -6,6 +7,7 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <optional>
 #include <random>
 #include <sstream>
 
@@ -16,7 +18,7 @@ int main(int argc, char* argv[])
      * handling of command line arguments
      ***********/
     if (argc <= 2) {
-        std::cerr << "usage: " << argv[0] << " purely_local_capacity(size_t) batch_blocking(0:None/1:DepthFirst/2:vEB)" << std::endl;
+        std::cerr << "usage: " << argv[0] << " purely_local_capacity(size_t) batch_blocking(0:None/1:DepthFirst/2:vEB/3:IncrementalDepthFirst/4:IncrementalvEB/5:BulkLoadDepthFirst/6:BulkLoadvEB/7:MultiLevelvEB) [workload]" << std::endl;
         std::quick_exit(EXIT_FAILURE);
     }
 
@@ -40,21 +42,60 @@ int main(int argc, char* argv[])
     }();
 
 
+    // optional; if given, the links are counted as many times as its queries follow them (see `Workload::parse` for the format)
+    const std::optional<Workload> workload = argc <= 3 ? std::nullopt : std::optional{Workload::parse(argv[3])};
+    const size_t n_elements = workload ? workload->n_elements : NumElements;
+
+
     /***********
      * instantiation of a collective allocator and a container
      ***********/
     using namespace FarMemoryContainer::Blocked;
     using namespace FarMalloc;
 
-    using Alloc = FarMalloc::CollectiveAllocator<ValueType, PageSize>;
-    BTreeMap<Key, Mapped, 2, std::less<Key>, Alloc> map{Alloc{purely_local_capacity}};
+    using Alloc = FarMalloc::CollectiveAllocator<ValueType, SwapUnitSize>;
+    BTreeMap<Key, Mapped, BTreeMaxNElems, std::less<Key>, Alloc> map{Alloc{purely_local_capacity}};
+
+
+    /***********
+     * incremental rearrangement of nodes for page-aware placement
+     *
+     * The subtrees touched by insertions are rearranged during the construction,
+     * instead of the batch rearrangement after that.
+     ***********/
+    switch (batch_blocking) {
+    case IncrementalDepthFirst:
+        map.incremental_block<SwapUnitSize>(IncrementalBlockingPeriod);
+        break;
+
+    case IncrementalvEB:
+        map.incremental_vEB<SwapUnitSize>(IncrementalBlockingPeriod);
+        break;
+
+    default:
+        break;
+    }
 
 
     /***********
      * insertion of `NumElements` elements
+     *
+     * In the bulk-loading modes, the nodes are laid out in the page-aware order from the beginning,
+     * so the batch rearrangement below is not needed.
      ***********/
     std::mt19937 prng;
-    const auto cons_dur = construct(prng, map);
+    const auto cons_dur = [&] {
+        switch (batch_blocking) {
+        case BulkLoadDepthFirst:
+            return bulk_construct(prng, [&](auto&& sorted) { map.bulk_load_block(sorted); }, n_elements);
+
+        case BulkLoadvEB:
+            return bulk_construct(prng, [&](auto&& sorted) { map.bulk_load_vEB(sorted); }, n_elements);
+
+        default:
+            return construct(prng, map, n_elements);
+        }
+    }();
 
 
     /***********
@@ -69,6 +110,10 @@ int main(int argc, char* argv[])
         map.batch_vEB();
         break;
 
+    case MultiLevelvEB:
+        map.batch_multilevel_vEB<PageSize>();
+        break;
+
     case None:
     default:
         break;
@@ -78,9 +123,12 @@ int main(int argc, char* argv[])
     /***********
      * calling the method of analysis of links between objects
      *
-     * `PageSize` is passed because container implementations doesn't know that
+     * `SwapUnitSize` is passed because container implementations doesn't know that
+     *
+     * If a workload is given, the links followed by its queries are counted instead, weighted by the frequency,
+     * without remote swapping (see `analyze_edges_in_workload` in include/workload.hpp).
      ***********/
-    auto [purely_local_edges, same_page_edges, diff_pages_edges] = map.analyze_edges<PageSize>();
+    auto [purely_local_edges, same_page_edges, diff_pages_edges] = workload ? analyze_edges_in_workload<SwapUnitSize>(prng, map, *workload) : map.analyze_edges<SwapUnitSize>();
 
     std::cout << "#NumElements\t"
               << "PurelyLocalCapacity[B]\t"
@@ -89,13 +137,16 @@ int main(int argc, char* argv[])
               << "purely_local_edges\t"
               << "same_page_edges\t"
               << "diff_pages_edges" << std::endl;
-    std::cout << NumElements << '\t'
+    std::cout << n_elements << '\t'
               << purely_local_capacity << "\t"
               << batch_blocking << '\t'
               << cons_dur.count() << '\t'
               << purely_local_edges << '\t'
               << same_page_edges << '\t'
               << diff_pages_edges << std::endl;
+    if (workload) {
+        workload->print(std::cout);
+    }
 
     std::quick_exit(EXIT_SUCCESS);
 }
@@ -1,4 +1,5 @@
 #include "setting_basis.hpp"
+#include "workload.hpp"
 
 #include <far_memory_container/blocked/skiplist.hpp>
 #include <farmalloc/collective_allocator.hpp>
@@ -6,6 +7,7 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <optional>
 #include <random>
 #include <sstream>
 
@@ -16,7 +18,7 @@ int main(int argc, char* argv[])
      * handling of command line arguments
      ***********/
     if (argc <= 2) {
-        std::cerr << "usage: " << argv[0] << " purely_local_capacity(size_t) batch_blocking(0:None/1:DepthFirst)" << std::endl;
+        std::cerr << "usage: " << argv[0] << " purely_local_capacity(size_t) batch_blocking(0:None/1:DepthFirst/2:vEB/5:BulkLoadDepthFirst) [workload]" << std::endl;
         std::quick_exit(EXIT_FAILURE);
     }
 
@@ -29,48 +31,69 @@ int main(int argc, char* argv[])
         }
         return tmp;
     }();
-    const bool batch_blocking = [&] {
+    const auto batch_blocking = [&] {
         int tmp;
         std::istringstream sstr{argv[2]};
         sstr >> tmp;
         if (sstr.fail()) {
             throw std::invalid_argument{std::string{argv[2]}};
         }
-        return static_cast<bool>(tmp);
+        return static_cast<BlockingMode>(tmp);
     }();
 
 
+    // optional; if given, the links are counted as many times as its queries follow them (see `Workload::parse` for the format)
+    const std::optional<Workload> workload = argc <= 3 ? std::nullopt : std::optional{Workload::parse(argv[3])};
+    const size_t n_elements = workload ? workload->n_elements : NumElements;
+
+
     /***********
      * instantiation of a collective allocator and a container
      ***********/
     using namespace FarMemoryContainer::Blocked;
     using namespace FarMalloc;
 
-    using Alloc = FarMalloc::CollectiveAllocator<ValueType, PageSize>;
+    using Alloc = FarMalloc::CollectiveAllocator<ValueType, SwapUnitSize>;
     SkiplistMap<Key, Mapped, std::less<Key>, Alloc> map{Alloc{purely_local_capacity}};
 
 
     /***********
      * insertion of `NumElements` elements
+     *
+     * In the bulk-loading mode, the nodes are laid out in the page-aware order from the beginning,
+     * so the batch rearrangement below is not needed.
      ***********/
     std::mt19937 prng;
-    const auto cons_dur = construct(prng, map);
+    const auto cons_dur = [&] {
+        switch (batch_blocking) {
+        case BulkLoadDepthFirst:
+            return bulk_construct(prng, [&](auto&& sorted) { map.bulk_load(sorted); }, n_elements);
+
+        default:
+            return construct(prng, map, n_elements);
+        }
+    }();
 
 
     /***********
      * batch rearrangement of nodes for page-aware placement
      ***********/
-    if (batch_blocking) {
+    if (batch_blocking == DepthFirst) {
         map.batch_block();
+    } else if (batch_blocking == vEB) {
+        map.batch_vEB();
     }
 
 
     /***********
      * calling the method of analysis of links between objects
      *
-     * `PageSize` is passed because container implementations doesn't know that
+     * `SwapUnitSize` is passed because container implementations doesn't know that
+     *
+     * If a workload is given, the links followed by its queries are counted instead, weighted by the frequency,
+     * without remote swapping (see `analyze_edges_in_workload` in include/workload.hpp).
      ***********/
-    auto [purely_local_edges, same_page_edges, diff_pages_edges] = map.analyze_edges<PageSize>();
+    auto [purely_local_edges, same_page_edges, diff_pages_edges] = workload ? analyze_edges_in_workload<SwapUnitSize>(prng, map, *workload) : map.analyze_edges<SwapUnitSize>();
 
     std::cout << "#NumElements\t"
               << "PurelyLocalCapacity[B]\t"
@@ -79,13 +102,16 @@ int main(int argc, char* argv[])
               << "purely_local_edges\t"
               << "same_page_edges\t"
               << "diff_pages_edges" << std::endl;
-    std::cout << NumElements << '\t'
+    std::cout << n_elements << '\t'
               << purely_local_capacity << "\t"
               << batch_blocking << '\t'
               << cons_dur.count() << '\t'
               << purely_local_edges << '\t'
               << same_page_edges << '\t'
               << diff_pages_edges << std::endl;
+    if (workload) {
+        workload->print(std::cout);
+    }
 
     std::quick_exit(EXIT_SUCCESS);
 }
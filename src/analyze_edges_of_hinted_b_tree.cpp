@@ -1,4 +1,5 @@
 #include "setting_basis.hpp"
+#include "workload.hpp"
 
 #include <far_memory_container/baseline/b_tree.hpp>
 #include <farmalloc/hint_allocator.hpp>
@@ -6,30 +7,36 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <optional>
 #include <random>
 
 
-int main()
+int main(int argc, char* argv[])
 {
     constexpr size_t purely_local_capacity = 0;
     constexpr bool batch_blocking = true;
 
 
+    // optional; if given, the links are counted as many times as its queries follow them (see `Workload::parse` for the format)
+    const std::optional<Workload> workload = argc <= 1 ? std::nullopt : std::optional{Workload::parse(argv[1])};
+    const size_t n_elements = workload ? workload->n_elements : NumElements;
+
+
     /***********
      * instantiation of a collective allocator and a container
      ***********/
     using namespace FarMemoryContainer::Baseline;
     using namespace FarMalloc;
 
-    using Alloc = FarMalloc::HintAllocator<ValueType, PageSize>;
-    BTreeMap<Key, Mapped, 2, std::less<Key>, Alloc> map{};
+    using Alloc = FarMalloc::HintAllocator<ValueType, SwapUnitSize>;
+    BTreeMap<Key, Mapped, BTreeMaxNElems, std::less<Key>, Alloc> map{};
 
 
     /***********
      * insertion of `NumElements` elements
      ***********/
     std::mt19937 prng;
-    const auto cons_dur = construct(prng, map);
+    const auto cons_dur = construct(prng, map, n_elements);
 
 
     /***********
@@ -43,9 +50,12 @@ int main()
     /***********
      * calling the method of analysis of links between objects
      *
-     * `PageSize` is passed because container implementations doesn't know that
+     * `SwapUnitSize` is passed because container implementations doesn't know that
+     *
+     * If a workload is given, the links followed by its queries are counted instead, weighted by the frequency,
+     * without remote swapping (see `analyze_edges_in_workload` in include/workload.hpp).
      ***********/
-    auto [purely_local_edges, same_page_edges, diff_pages_edges] = map.analyze_edges<PageSize>();
+    auto [purely_local_edges, same_page_edges, diff_pages_edges] = workload ? analyze_edges_in_workload<SwapUnitSize>(prng, map, *workload) : map.analyze_edges<SwapUnitSize>();
 
     std::cout << "#NumElements\t"
               << "PurelyLocalCapacity[B]\t"
@@ -54,13 +64,16 @@ int main()
               << "purely_local_edges\t"
               << "same_page_edges\t"
               << "diff_pages_edges" << std::endl;
-    std::cout << NumElements << '\t'
+    std::cout << n_elements << '\t'
               << purely_local_capacity << "\t"
               << batch_blocking << '\t'
               << cons_dur.count() << '\t'
               << purely_local_edges << '\t'
               << same_page_edges << '\t'
               << diff_pages_edges << std::endl;
+    if (workload) {
+        workload->print(std::cout);
+    }
 
     std::quick_exit(EXIT_SUCCESS);
 }
@@ -1,4 +1,5 @@
 #include "setting_basis.hpp"
+#include "workload.hpp"
 
 #include <far_memory_container/baseline/skiplist.hpp>
 #include <farmalloc/hint_allocator.hpp>
@@ -6,13 +7,33 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <optional>
 #include <random>
+#include <sstream>
 
 
-int main()
+int main(int argc, char* argv[])
 {
     constexpr size_t purely_local_capacity = 0;
-    constexpr bool batch_blocking = true;
+    // optional, DepthFirst by default
+    const auto batch_blocking = [&] {
+        if (argc <= 1) {
+            return DepthFirst;
+        }
+        int tmp;
+        std::istringstream sstr{argv[1]};
+        sstr >> tmp;
+        if (sstr.fail() || (tmp != DepthFirst && tmp != vEB && tmp != BulkLoadDepthFirst)) {
+            std::cerr << "usage: " << argv[0] << " [batch_blocking(1:DepthFirst/2:vEB/5:BulkLoadDepthFirst)] [workload]" << std::endl;
+            std::quick_exit(EXIT_FAILURE);
+        }
+        return static_cast<BlockingMode>(tmp);
+    }();
+
+
+    // optional; if given, the links are counted as many times as its queries follow them (see `Workload::parse` for the format)
+    const std::optional<Workload> workload = argc <= 2 ? std::nullopt : std::optional{Workload::parse(argv[2])};
+    const size_t n_elements = workload ? workload->n_elements : NumElements;
 
 
     /***********
@@ -21,31 +42,47 @@ int main()
     using namespace FarMemoryContainer::Baseline;
     using namespace FarMalloc;
 
-    using Alloc = FarMalloc::HintAllocator<ValueType, PageSize>;
+    using Alloc = FarMalloc::HintAllocator<ValueType, SwapUnitSize>;
     SkiplistMap<Key, Mapped, std::less<Key>, Alloc> map{};
 
 
     /***********
      * insertion of `NumElements` elements
+     *
+     * In the bulk-loading mode, the nodes are laid out in the page-aware order from the beginning,
+     * so the batch rearrangement below is not needed.
      ***********/
     std::mt19937 prng;
-    const auto cons_dur = construct(prng, map);
+    const auto cons_dur = [&] {
+        switch (batch_blocking) {
+        case BulkLoadDepthFirst:
+            return bulk_construct(prng, [&](auto&& sorted) { map.bulk_load(sorted); }, n_elements);
+
+        default:
+            return construct(prng, map, n_elements);
+        }
+    }();
 
 
     /***********
      * batch rearrangement of nodes
      ***********/
-    if (batch_blocking) {
+    if (batch_blocking == DepthFirst) {
         map.batch_block();
+    } else if (batch_blocking == vEB) {
+        map.batch_vEB();
     }
 
 
     /***********
      * calling the method of analysis of links between objects
      *
-     * `PageSize` is passed because container implementations doesn't know that
+     * `SwapUnitSize` is passed because container implementations doesn't know that
+     *
+     * If a workload is given, the links followed by its queries are counted instead, weighted by the frequency,
+     * without remote swapping (see `analyze_edges_in_workload` in include/workload.hpp).
      ***********/
-    auto [purely_local_edges, same_page_edges, diff_pages_edges] = map.analyze_edges<PageSize>();
+    auto [purely_local_edges, same_page_edges, diff_pages_edges] = workload ? analyze_edges_in_workload<SwapUnitSize>(prng, map, *workload) : map.analyze_edges<SwapUnitSize>();
 
     std::cout << "#NumElements\t"
               << "PurelyLocalCapacity[B]\t"
@@ -54,13 +91,16 @@ int main()
               << "purely_local_edges\t"
               << "same_page_edges\t"
               << "diff_pages_edges" << std::endl;
-    std::cout << NumElements << '\t'
+    std::cout << n_elements << '\t'
               << purely_local_capacity << "\t"
               << batch_blocking << '\t'
               << cons_dur.count() << '\t'
               << purely_local_edges << '\t'
               << same_page_edges << '\t'
               << diff_pages_edges << std::endl;
+    if (workload) {
+        workload->print(std::cout);
+    }
 
     std::quick_exit(EXIT_SUCCESS);
 }
@@ -19,7 +19,7 @@ int main(int argc, char* argv[])
      * handling of command line arguments
      ***********/
     if (argc <= 2) {
-        std::cerr << "usage: " << argv[0] << " purely_local_capacity(size_t) batch_blocking(0:None/1:DepthFirst/2:vEB)" << std::endl;
+        std::cerr << "usage: " << argv[0] << " purely_local_capacity(size_t) batch_blocking(0:None/1:DepthFirst/2:vEB/3:IncrementalDepthFirst/4:IncrementalvEB/5:BulkLoadDepthFirst/6:BulkLoadvEB/7:MultiLevelvEB) [n_threads(size_t) [workload(name=value,...)]]" << std::endl;
         std::quick_exit(EXIT_FAILURE);
     }
 
@@ -41,6 +41,21 @@ int main(int argc, char* argv[])
         }
         return static_cast<BlockingMode>(tmp);
     }();
+    // optional, a single thread by default
+    const size_t n_threads = [&] {
+        if (argc <= 3) {
+            return size_t{1};
+        }
+        size_t tmp;
+        std::istringstream sstr{argv[3]};
+        sstr >> tmp;
+        if (sstr.fail() || tmp == 0) {
+            throw std::invalid_argument{std::string{argv[3]}};
+        }
+        return tmp;
+    }();
+    // optional, the original benchmark by default (see `Workload::parse` for the format)
+    const Workload workload = argc <= 4 ? Workload{} : Workload::parse(argv[4]);
 
 
     /***********
@@ -49,15 +64,57 @@ int main(int argc, char* argv[])
     using namespace FarMemoryContainer::Blocked;
     using namespace FarMalloc;
 
-    using Alloc = FarMalloc::CollectiveAllocator<ValueType, PageSize>;
-    BTreeMap<Key, Mapped, 2, std::less<Key>, Alloc> map{Alloc{purely_local_capacity}};
+    using Alloc = FarMalloc::CollectiveAllocator<ValueType, SwapUnitSize>;
+#ifdef SPLIT_VALUES
+    // The elements are out of line, and the nodes hold only their keys.
+    BTreeMap<Key, Mapped, BTreeMaxNElems, std::less<Key>, Alloc, false, false, true> map{Alloc{purely_local_capacity}};
+#elif defined(SEPARATE_KEYS)
+    // The nodes keep a copy of the keys contiguously, which is searched by SIMD if the target supports it (see `KEY_SEARCH_ISA` in CMakeLists.txt).
+    BTreeMap<Key, Mapped, BTreeMaxNElems, std::less<Key>, Alloc, false, true> map{Alloc{purely_local_capacity}};
+#else
+    BTreeMap<Key, Mapped, BTreeMaxNElems, std::less<Key>, Alloc> map{Alloc{purely_local_capacity}};
+#endif
 
 
     /***********
-     * insertion of `NumElements` elements
+     * incremental rearrangement of nodes for page-aware placement
+     *
+     * The subtrees touched by insertions are rearranged during the construction,
+     * instead of the batch rearrangement after that.
+     ***********/
+    switch (batch_blocking) {
+    case IncrementalDepthFirst:
+        map.incremental_block<SwapUnitSize>(IncrementalBlockingPeriod);
+        break;
+
+    case IncrementalvEB:
+        map.incremental_vEB<SwapUnitSize>(IncrementalBlockingPeriod);
+        break;
+
+    default:
+        break;
+    }
+
+
+    /***********
+     * insertion of `workload.n_elements` elements
+     *
+     * In the bulk-loading modes, the nodes are laid out in the page-aware order from the beginning,
+     * so the batch rearrangement below is not needed.
      ***********/
     std::mt19937 prng;
-    const auto cons_dur = construct(prng, map);
+    const auto cons_dur = [&] {
+        switch (batch_blocking) {
+        case BulkLoadDepthFirst:
+            return bulk_construct(prng, [&](auto&& sorted) { map.bulk_load_block(sorted); }, workload.n_elements);
+
+        case BulkLoadvEB:
+            return bulk_construct(prng, [&](auto&& sorted) { map.bulk_load_vEB(sorted); }, workload.n_elements);
+
+        default:
+            return construct(prng, map, workload.n_elements);
+        }
+    }();
 
 
     /***********
@@ -72,12 +129,52 @@ int main(int argc, char* argv[])
         map.batch_vEB();
         break;
 
+    case MultiLevelvEB:
+        map.batch_multilevel_vEB<PageSize>();
+        break;
+
     case None:
     default:
         break;
     }
 
 
+    /***********
+     * pinning of the elements of the hottest keys, if `workload.n_pinned` is positive
+     *
+     * Only the containers holding the elements out of line support it.
+     ***********/
+    KeySpace key_space{workload};
+    pin_hot_values(map, workload, key_space);
+
+
+    /***********
+     * the depth of the tree, i.e., the number of the nodes visited by a lookup of a leaf
+     *
+     * It is taken before remote swapping is enabled, not to count the nodes visited.
+     ***********/
+    const size_t height = map.height();
+    /***********
+     * the purely local memory used by the index and by the elements
+     *
+     * It visits all the nodes, so it is also taken before remote swapping is enabled,
+     * i.e., for the layout before the churn phase and the queries.
+     ***********/
+    const auto [local_index_footprint, local_value_footprint] = map.local_footprint();
+
+
+    /***********
+     * tracing of the accesses of the queries instead of running them, if `workload.trace_path` is given
+     *
+     * The queries only visit the nodes without remote swapping, and the trace is replayed by `replay_trace`
+     * for any size of the page cache (see `TRACE` in scripts/kvs_benchmark.sh).
+     ***********/
+    if (!workload.trace_path.empty()) {
+        trace_workload(prng, map, workload, key_space);
+        std::quick_exit(EXIT_SUCCESS);
+    }
+
+
     /***********
      * enable remote swapping for the swappable region
      *
@@ -95,10 +192,28 @@ int main(int argc, char* argv[])
     LocalMemoryStore::write_cnt = 0;
 
 
+    /***********
+     * churn phase, if `workload.churn_iterations` is positive
+     *
+     * New keys are inserted and existing keys are erased, which moves nodes between
+     * the purely local and the swappable regions.  The swapping counters are reset again after that.
+     ***********/
+    const auto churn_result = workload.churn_iterations == 0 ? QueryResult{} : parallel_workload(prng, map, workload.churn(), n_threads, key_space);
+    const auto churn_swaps = churn_result.merged_swaps();
+    const size_t churn_read_cnt = LocalMemoryStore::read_cnt, churn_write_cnt = LocalMemoryStore::write_cnt;
+    LocalMemoryStore::read_cnt = 0;
+    LocalMemoryStore::write_cnt = 0;
+
+
     /***********
      * running "key-value store benchmark"
+     *
+     * Each of `n_threads` threads runs `workload.n_iterations` operations of `workload` with its own PRNG.
      ***********/
-    const auto query_dur = range_query(prng, map);
+    const auto query_result = parallel_workload(prng, map, workload, n_threads, key_space);
+    const auto tail_latencies = query_result.tail_latencies();
+    const auto swaps = query_result.merged_swaps();
+    const size_t query_read_cnt = LocalMemoryStore::read_cnt, query_write_cnt = LocalMemoryStore::write_cnt;
 
     std::cout << "#NumElements\t"
               << "NIteration\t"
@@ -110,18 +225,60 @@ int main(int argc, char* argv[])
               << "construction_duration[ns]\t"
               << "query_duration[ns]\t"
               << "query_read_cnt\t"
-              << "query_write_cnt" << std::endl;
-    std::cout << NumElements << '\t'
-              << NIteration << '\t'
-              << ZipfSkewness << '\t'
-              << UpdateRatio << "\t"
+              << "query_write_cnt\t"
+              << "NThreads\t"
+              << "query_throughput[ops/s]\t"
+              << "query_mean_latency[ns]\t"
+              << "query_max_latency[ns]\t"
+              << "query_p50_latency[ns]\t"
+              << "query_p99_latency[ns]\t"
+              << "query_p999_latency[ns]\t"
+              << "query_update_swap_ins\t"
+              << "query_point_read_swap_ins\t"
+              << "query_range_read_swap_ins\t"
+              << "churn_duration[ns]\t"
+              << "churn_throughput[ops/s]\t"
+              << "churn_read_cnt\t"
+              << "churn_write_cnt\t"
+              << "churn_insert_swap_ins\t"
+              << "churn_erase_swap_ins\t"
+              << "local_index_footprint[B]\t"
+              << "local_value_footprint[B]\t"
+              << "MaxNElems\t"
+              << "height" << std::endl;
+    std::cout << workload.n_elements << '\t'
+              << workload.n_iterations << '\t'
+              << workload.zipf_skewness << '\t'
+              << workload.update_ratio() << "\t"
               << purely_local_capacity << "\t"
               << umapcfg_get_max_pages_in_buffer() << '\t'
               << static_cast<int>(batch_blocking) << '\t'
               << cons_dur.count() << '\t'
-              << query_dur.count() << "\t"
-              << LocalMemoryStore::read_cnt << '\t'
-              << LocalMemoryStore::write_cnt << std::endl;
+              << query_result.duration.count() << "\t"
+              << query_read_cnt << '\t'
+              << query_write_cnt << '\t'
+              << n_threads << '\t'
+              << query_result.throughput() << '\t'
+              << query_result.mean_latency().count() << '\t'
+              << query_result.max_latency().count() << '\t'
+              << tail_latencies[0].count() << '\t'
+              << tail_latencies[1].count() << '\t'
+              << tail_latencies[2].count() << '\t'
+              << swaps.update_swap_ins() << '\t'
+              << swaps.point_read_swap_ins() << '\t'
+              << swaps.range_read_swap_ins() << '\t'
+              << churn_result.duration.count() << '\t'
+              << churn_result.throughput() << '\t'
+              << churn_read_cnt << '\t'
+              << churn_write_cnt << '\t'
+              << churn_swaps.insert_swap_ins() << '\t'
+              << churn_swaps.erase_swap_ins() << '\t'
+              << local_index_footprint << '\t'
+              << local_value_footprint << '\t'
+              << BTreeMaxNElems << '\t'
+              << height << std::endl;
+    workload.print(std::cout);
+    swaps.print(std::cout);
 
     std::quick_exit(EXIT_SUCCESS);
 }
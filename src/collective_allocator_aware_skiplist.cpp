@@ -19,7 +19,7 @@ int main(int argc, char* argv[])
      * handling of command line arguments
      ***********/
     if (argc <= 2) {
-        std::cerr << "usage: " << argv[0] << " purely_local_capacity(size_t) batch_blocking(0:None/1:DepthFirst)" << std::endl;
+        std::cerr << "usage: " << argv[0] << " purely_local_capacity(size_t) batch_blocking(0:None/1:DepthFirst/2:vEB/5:BulkLoadDepthFirst) [n_threads(size_t) [workload(name=value,...)]]" << std::endl;
         std::quick_exit(EXIT_FAILURE);
     }
 
@@ -32,15 +32,30 @@ int main(int argc, char* argv[])
         }
         return tmp;
     }();
-    const bool batch_blocking = [&] {
+    const auto batch_blocking = [&] {
         int tmp;
         std::istringstream sstr{argv[2]};
         sstr >> tmp;
         if (sstr.fail()) {
             throw std::invalid_argument{std::string{argv[2]}};
         }
-        return static_cast<bool>(tmp);
+        return static_cast<BlockingMode>(tmp);
     }();
+    // optional, a single thread by default
+    const size_t n_threads = [&] {
+        if (argc <= 3) {
+            return size_t{1};
+        }
+        size_t tmp;
+        std::istringstream sstr{argv[3]};
+        sstr >> tmp;
+        if (sstr.fail() || tmp == 0) {
+            throw std::invalid_argument{std::string{argv[3]}};
+        }
+        return tmp;
+    }();
+    // optional, the original benchmark by default (see `Workload::parse` for the format)
+    const Workload workload = argc <= 4 ? Workload{} : Workload::parse(argv[4]);
 
     using namespace FarMemoryContainer::Blocked;
     using namespace FarMalloc;
@@ -49,22 +64,48 @@ int main(int argc, char* argv[])
     /***********
      * instantiation of a collective allocator and a container
      ***********/
-    using Alloc = FarMalloc::CollectiveAllocator<ValueType, PageSize>;
+    using Alloc = FarMalloc::CollectiveAllocator<ValueType, SwapUnitSize>;
     SkiplistMap<Key, Mapped, std::less<Key>, Alloc> map{Alloc{purely_local_capacity}};
 
 
     /***********
-     * insertion of `NumElements` elements
+     * insertion of `workload.n_elements` elements
+     *
+     * In the bulk-loading mode, the nodes are laid out in the page-aware order from the beginning,
+     * so the batch rearrangement below is not needed.
      ***********/
     std::mt19937 prng;
-    const auto cons_dur = construct(prng, map);
+    const auto cons_dur = [&] {
+        switch (batch_blocking) {
+        case BulkLoadDepthFirst:
+            return bulk_construct(prng, [&](auto&& sorted) { map.bulk_load(sorted); }, workload.n_elements);
+
+        default:
+            return construct(prng, map, workload.n_elements);
+        }
+    }();
 
 
     /***********
      * batch rearrangement of nodes for page-aware placement
      ***********/
-    if (batch_blocking) {
+    if (batch_blocking == DepthFirst) {
         map.batch_block();
+    } else if (batch_blocking == vEB) {
+        map.batch_vEB();
+    }
+
+
+    /***********
+     * tracing of the accesses of the queries instead of running them, if `workload.trace_path` is given
+     *
+     * The queries only visit the nodes without remote swapping, and the trace is replayed by `replay_trace`
+     * for any size of the page cache (see `TRACE` in scripts/kvs_benchmark.sh).
+     ***********/
+    if (!workload.trace_path.empty()) {
+        KeySpace key_space{workload};
+        trace_workload(prng, map, workload, key_space);
+        std::quick_exit(EXIT_SUCCESS);
     }
 
 
@@ -85,10 +126,28 @@ int main(int argc, char* argv[])
     LocalMemoryStore::write_cnt = 0;
 
 
+    /***********
+     * churn phase, if `workload.churn_iterations` is positive
+     *
+     * New keys are inserted and existing keys are erased, which moves nodes between
+     * the purely local and the swappable regions.  The swapping counters are reset again after that.
+     ***********/
+    KeySpace key_space{workload};
+    const auto churn_result = workload.churn_iterations == 0 ? QueryResult{} : parallel_workload(prng, map, workload.churn(), n_threads, key_space);
+    const auto churn_swaps = churn_result.merged_swaps();
+    const size_t churn_read_cnt = LocalMemoryStore::read_cnt, churn_write_cnt = LocalMemoryStore::write_cnt;
+    LocalMemoryStore::read_cnt = 0;
+    LocalMemoryStore::write_cnt = 0;
+
+
     /***********
      * running "key-value store benchmark"
+     *
+     * Each of `n_threads` threads runs `workload.n_iterations` operations of `workload` with its own PRNG.
      ***********/
-    const auto query_dur = range_query(prng, map);
+    const auto query_result = parallel_workload(prng, map, workload, n_threads, key_space);
+    const auto tail_latencies = query_result.tail_latencies();
+    const auto swaps = query_result.merged_swaps();
 
     std::cout << "#NumElements\t"
               << "NIteration\t"
@@ -100,18 +159,52 @@ int main(int argc, char* argv[])
               << "construction_duration[ns]\t"
               << "query_duration[ns]\t"
               << "query_read_cnt\t"
-              << "query_write_cnt" << std::endl;
-    std::cout << NumElements << '\t'
-              << NIteration << '\t'
-              << ZipfSkewness << '\t'
-              << UpdateRatio << "\t"
+              << "query_write_cnt\t"
+              << "NThreads\t"
+              << "query_throughput[ops/s]\t"
+              << "query_mean_latency[ns]\t"
+              << "query_max_latency[ns]\t"
+              << "query_p50_latency[ns]\t"
+              << "query_p99_latency[ns]\t"
+              << "query_p999_latency[ns]\t"
+              << "query_update_swap_ins\t"
+              << "query_point_read_swap_ins\t"
+              << "query_range_read_swap_ins\t"
+              << "churn_duration[ns]\t"
+              << "churn_throughput[ops/s]\t"
+              << "churn_read_cnt\t"
+              << "churn_write_cnt\t"
+              << "churn_insert_swap_ins\t"
+              << "churn_erase_swap_ins" << std::endl;
+    std::cout << workload.n_elements << '\t'
+              << workload.n_iterations << '\t'
+              << workload.zipf_skewness << '\t'
+              << workload.update_ratio() << "\t"
               << purely_local_capacity << "\t"
               << umapcfg_get_max_pages_in_buffer() << '\t'
               << static_cast<int>(batch_blocking) << '\t'
               << cons_dur.count() << '\t'
-              << query_dur.count() << "\t"
+              << query_result.duration.count() << "\t"
               << LocalMemoryStore::read_cnt << '\t'
-              << LocalMemoryStore::write_cnt << std::endl;
+              << LocalMemoryStore::write_cnt << '\t'
+              << n_threads << '\t'
+              << query_result.throughput() << '\t'
+              << query_result.mean_latency().count() << '\t'
+              << query_result.max_latency().count() << '\t'
+              << tail_latencies[0].count() << '\t'
+              << tail_latencies[1].count() << '\t'
+              << tail_latencies[2].count() << '\t'
+              << swaps.update_swap_ins() << '\t'
+              << swaps.point_read_swap_ins() << '\t'
+              << swaps.range_read_swap_ins() << '\t'
+              << churn_result.duration.count() << '\t'
+              << churn_result.throughput() << '\t'
+              << churn_read_cnt << '\t'
+              << churn_write_cnt << '\t'
+              << churn_swaps.insert_swap_ins() << '\t'
+              << churn_swaps.erase_swap_ins() << std::endl;
+    workload.print(std::cout);
+    swaps.print(std::cout);
 
     std::quick_exit(EXIT_SUCCESS);
 }
@@ -13,10 +13,25 @@
 #include <stdexcept>
 
 
-int main()
+int main(int argc, char* argv[])
 {
     constexpr size_t purely_local_capacity = 0;
     constexpr bool batch_blocking = true;
+    // optional, a single thread by default
+    const size_t n_threads = [&] {
+        if (argc <= 1) {
+            return size_t{1};
+        }
+        size_t tmp;
+        std::istringstream sstr{argv[1]};
+        sstr >> tmp;
+        if (sstr.fail() || tmp == 0) {
+            throw std::invalid_argument{std::string{argv[1]}};
+        }
+        return tmp;
+    }();
+    // optional, the original benchmark by default (see `Workload::parse` for the format)
+    const Workload workload = argc <= 2 ? Workload{} : Workload::parse(argv[2]);
 
     /***********
      * instantiation of a collective allocator and a container
@@ -28,15 +43,15 @@ int main()
     /***********
      * instantiation of a collective allocator and a container
      ***********/
-    using Alloc = FarMalloc::HintAllocator<ValueType, PageSize>;
-    BTreeMap<Key, Mapped, 2, std::less<Key>, Alloc> map{};
+    using Alloc = FarMalloc::HintAllocator<ValueType, SwapUnitSize>;
+    BTreeMap<Key, Mapped, BTreeMaxNElems, std::less<Key>, Alloc> map{};
 
 
     /***********
-     * insertion of `NumElements` elements
+     * insertion of `workload.n_elements` elements
      ***********/
     std::mt19937 prng;
-    const auto cons_dur = construct(prng, map);
+    const auto cons_dur = construct(prng, map, workload.n_elements);
 
 
     /***********
@@ -47,6 +62,27 @@ int main()
     }
 
 
+    /***********
+     * the depth of the tree, i.e., the number of the nodes visited by a lookup of a leaf
+     *
+     * It is taken before remote swapping is enabled, not to count the nodes visited.
+     ***********/
+    const size_t height = map.height();
+
+
+    /***********
+     * tracing of the accesses of the queries instead of running them, if `workload.trace_path` is given
+     *
+     * The queries only visit the nodes without remote swapping, and the trace is replayed by `replay_trace`
+     * for any size of the page cache (see `TRACE` in scripts/kvs_benchmark.sh).
+     ***********/
+    if (!workload.trace_path.empty()) {
+        KeySpace key_space{workload};
+        trace_workload(prng, map, workload, key_space);
+        std::quick_exit(EXIT_SUCCESS);
+    }
+
+
     /***********
      * enable remote swapping for the swappable region
      *
@@ -64,10 +100,28 @@ int main()
     LocalMemoryStore::write_cnt = 0;
 
 
+    /***********
+     * churn phase, if `workload.churn_iterations` is positive
+     *
+     * New keys are inserted and existing keys are erased, which moves nodes between
+     * the purely local and the swappable regions.  The swapping counters are reset again after that.
+     ***********/
+    KeySpace key_space{workload};
+    const auto churn_result = workload.churn_iterations == 0 ? QueryResult{} : parallel_workload(prng, map, workload.churn(), n_threads, key_space);
+    const auto churn_swaps = churn_result.merged_swaps();
+    const size_t churn_read_cnt = LocalMemoryStore::read_cnt, churn_write_cnt = LocalMemoryStore::write_cnt;
+    LocalMemoryStore::read_cnt = 0;
+    LocalMemoryStore::write_cnt = 0;
+
+
     /***********
      * running "key-value store benchmark"
+     *
+     * Each of `n_threads` threads runs `workload.n_iterations` operations of `workload` with its own PRNG.
      ***********/
-    const auto query_dur = range_query(prng, map);
+    const auto query_result = parallel_workload(prng, map, workload, n_threads, key_space);
+    const auto tail_latencies = query_result.tail_latencies();
+    const auto swaps = query_result.merged_swaps();
 
     std::cout << "#NumElements\t"
               << "NIteration\t"
@@ -79,18 +133,56 @@ int main()
               << "construction_duration[ns]\t"
               << "query_duration[ns]\t"
               << "query_read_cnt\t"
-              << "query_write_cnt" << std::endl;
-    std::cout << NumElements << '\t'
-              << NIteration << '\t'
-              << ZipfSkewness << '\t'
-              << UpdateRatio << "\t"
+              << "query_write_cnt\t"
+              << "NThreads\t"
+              << "query_throughput[ops/s]\t"
+              << "query_mean_latency[ns]\t"
+              << "query_max_latency[ns]\t"
+              << "query_p50_latency[ns]\t"
+              << "query_p99_latency[ns]\t"
+              << "query_p999_latency[ns]\t"
+              << "query_update_swap_ins\t"
+              << "query_point_read_swap_ins\t"
+              << "query_range_read_swap_ins\t"
+              << "churn_duration[ns]\t"
+              << "churn_throughput[ops/s]\t"
+              << "churn_read_cnt\t"
+              << "churn_write_cnt\t"
+              << "churn_insert_swap_ins\t"
+              << "churn_erase_swap_ins\t"
+              << "MaxNElems\t"
+              << "height" << std::endl;
+    std::cout << workload.n_elements << '\t'
+              << workload.n_iterations << '\t'
+              << workload.zipf_skewness << '\t'
+              << workload.update_ratio() << "\t"
               << purely_local_capacity << "\t"
               << umapcfg_get_max_pages_in_buffer() << '\t'
               << batch_blocking << '\t'
               << cons_dur.count() << '\t'
-              << query_dur.count() << "\t"
+              << query_result.duration.count() << "\t"
               << LocalMemoryStore::read_cnt << '\t'
-              << LocalMemoryStore::write_cnt << std::endl;
+              << LocalMemoryStore::write_cnt << '\t'
+              << n_threads << '\t'
+              << query_result.throughput() << '\t'
+              << query_result.mean_latency().count() << '\t'
+              << query_result.max_latency().count() << '\t'
+              << tail_latencies[0].count() << '\t'
+              << tail_latencies[1].count() << '\t'
+              << tail_latencies[2].count() << '\t'
+              << swaps.update_swap_ins() << '\t'
+              << swaps.point_read_swap_ins() << '\t'
+              << swaps.range_read_swap_ins() << '\t'
+              << churn_result.duration.count() << '\t'
+              << churn_result.throughput() << '\t'
+              << churn_read_cnt << '\t'
+              << churn_write_cnt << '\t'
+              << churn_swaps.insert_swap_ins() << '\t'
+              << churn_swaps.erase_swap_ins() << '\t'
+              << BTreeMaxNElems << '\t'
+              << height << std::endl;
+    workload.print(std::cout);
+    swaps.print(std::cout);
 
     std::quick_exit(EXIT_SUCCESS);
 }
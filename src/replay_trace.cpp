@@ -0,0 +1,95 @@
+#include <far_memory_container/access_trace.hpp>
+#include <far_memory_container/page_cache_simulator.hpp>
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+int main(int argc, char* argv[])
+{
+    using namespace FarMemoryContainer;
+
+
+    /***********
+     * handling of command line arguments
+     ***********/
+    const auto exit_with_usage = [&] {
+        std::cerr << "usage: " << argv[0] << " trace_file replacement(fifo/lru/clock) cache_size_in_pages(size_t)..." << std::endl;
+        std::quick_exit(EXIT_FAILURE);
+    };
+    if (argc <= 3) {
+        exit_with_usage();
+    }
+
+    const std::string trace_path = argv[1];
+    const std::string_view replacement_name = argv[2];
+    const auto replacement = [&] {
+        if (replacement_name == "fifo") {
+            return PageReplacement::FIFO;
+        } else if (replacement_name == "lru") {
+            return PageReplacement::LRU;
+        } else if (replacement_name != "clock") {
+            exit_with_usage();
+        }
+        return PageReplacement::CLOCK;
+    }();
+    std::vector<size_t> cache_sizes;
+    for (int i = 3; i < argc; i++) {
+        size_t tmp;
+        std::istringstream sstr{argv[i]};
+        sstr >> tmp;
+        if (sstr.fail()) {
+            exit_with_usage();
+        }
+        cache_sizes.push_back(tmp);
+    }
+
+
+    /***********
+     * replaying the trace for each size of the page cache
+     *
+     * The cache is empty at first, as all the pages are flushed when remote swapping is enabled.
+     * The misses estimate `query_read_cnt` of the benchmark, i.e., the pages swapped in during the queries,
+     * and the evictions the pages swapped out, if all the pages evicted are dirty.
+     ***********/
+    AccessTraceReader trace{trace_path};
+
+    std::cout << "#trace\t"
+              << "page_size[B]\t"
+              << "replacement\t"
+              << "UMAP_BUFSIZE[pages]\t"
+              << "n_queries\t"
+              << "purely_local\t"
+              << "cache_hit\t"
+              << "cache_miss\t"
+              << "evictions" << std::endl;
+    for (const auto cache_size : cache_sizes) {
+        PageCacheSimulator cache{cache_size, replacement};
+        size_t n_queries = 0, n_local = 0;
+        const auto access = [&](uintptr_t page_id, bool is_local) {
+            if (is_local) {
+                n_local++;
+            } else {
+                cache.access(page_id);
+            }
+        };
+        trace.replay(access, [&] { n_queries++; });
+
+        std::cout << trace_path << '\t'
+                  << trace.page_size() << '\t'
+                  << replacement_name << '\t'
+                  << cache_size << '\t'
+                  << n_queries << '\t'
+                  << n_local << '\t'
+                  << cache.n_hits() << '\t'
+                  << cache.n_misses() << '\t'
+                  << cache.n_evictions() << std::endl;
+    }
+
+    std::quick_exit(EXIT_SUCCESS);
+}
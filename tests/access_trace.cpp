@@ -0,0 +1,102 @@
+#include <far_memory_container/access_trace.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+
+// tests of the trace of the accesses written by `AccessTraceWriter` and read back by `AccessTraceReader`
+
+using namespace FarMemoryContainer;
+
+constexpr size_t TracePageSize = 4096;
+
+[[noreturn]] void fail(std::string_view test, std::string_view what)
+{
+    std::cerr << test << ": " << what << std::endl;
+    std::exit(EXIT_FAILURE);
+}
+
+//! the accesses of each query, as `(page_id, is_local)`
+using Queries = std::vector<std::vector<std::pair<uintptr_t, bool>>>;
+
+//! writes `queries` as the accesses of addresses in their pages, and reads them back
+//! More accesses than the buffer of the writer cross its flushes.
+void test_round_trip(const std::string& path, size_t n_queries)
+{
+    std::mt19937_64 prng{n_queries};
+    Queries queries(n_queries);
+    for (auto& accesses : queries) {
+        accesses.resize(prng() % 8);
+        for (auto& [page_id, is_local] : accesses) {
+            page_id = prng() % (uintptr_t{1} << 40);
+            is_local = prng() % 2 == 0;
+        }
+    }
+
+    {
+        AccessTraceWriter writer{path, TracePageSize};
+        for (const auto& accesses : queries) {
+            for (const auto& [page_id, is_local] : accesses) {
+                const auto address = page_id * TracePageSize + prng() % TracePageSize;
+                writer(reinterpret_cast<const void*>(address), is_local);
+            }
+            writer.end_query();
+        }
+        if (writer.n_queries() != n_queries) {
+            fail("round trip", "wrong number of the queries written");
+        }
+    }
+
+    AccessTraceReader reader{path};
+    if (reader.page_size() != TracePageSize) {
+        fail("round trip", "wrong page size");
+    }
+    // replayed twice, as `replay_trace` does for each size of the page cache
+    for (size_t i = 0; i != 2; i++) {
+        Queries read(1);
+        reader.replay([&](uintptr_t page_id, bool is_local) { read.back().emplace_back(page_id, is_local); },
+            [&] { read.emplace_back(); });
+        read.pop_back();
+        if (read != queries) {
+            fail("round trip", "wrong accesses read");
+        }
+    }
+}
+
+//! a file which is not a trace, i.e., without the page size
+void test_not_a_trace(const std::string& path)
+{
+    std::ofstream{path, std::ios::binary | std::ios::trunc};
+    try {
+        AccessTraceReader reader{path};
+    } catch (std::runtime_error&) {
+        return;
+    }
+    fail("not a trace", "an empty file read as a trace");
+}
+
+int main()
+{
+    const auto path = (std::filesystem::temp_directory_path() / ("access_trace_test_" + std::to_string(::getpid()))).string();
+
+    test_round_trip(path, 0);
+    test_round_trip(path, 100);
+    test_round_trip(path, 100000);
+    test_not_a_trace(path);
+
+    std::filesystem::remove(path);
+    std::cout << "ok" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,172 @@
+#include <far_memory_container/blocked/b_tree.hpp>
+#include <farmalloc/collective_allocator.hpp>
+#include <farmalloc/page_size.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string_view>
+
+
+// regression tests of the local prefix of `Blocked::BTreeMap`, i.e., the purely local nodes at the beginning of its list,
+// under the operations which move nodes into and out of the purely local region together with insertions and erasures
+
+using Key = uint64_t;
+using Mapped = std::array<std::byte, 40>;
+using ValueType = std::pair<const Key, Mapped>;
+
+constexpr size_t PurelyLocalCapacity = 30000;
+constexpr Key KeyRange = 20000;
+
+Mapped mapped_of(Key key)
+{
+    Mapped res{};
+    for (size_t i = 0; i != res.size(); i++) {
+        res[i] = static_cast<std::byte>(key * 7 + i);
+    }
+    return res;
+}
+
+[[noreturn]] void fail(std::string_view test, unsigned seed, std::string_view what)
+{
+    std::cerr << test << " (seed " << seed << "): " << what << std::endl;
+    std::exit(EXIT_FAILURE);
+}
+
+template <class MapType>
+void check_contents(std::string_view test, unsigned seed, MapType& map, const std::map<Key, Mapped>& reference)
+{
+    if (map.size() != reference.size()) {
+        fail(test, seed, "wrong size");
+    }
+    auto iter = map.begin();
+    for (const auto& [key, mapped] : reference) {
+        if (iter == map.end() || iter->first != key || iter->second != mapped) {
+            fail(test, seed, "wrong element");
+        }
+        ++iter;
+    }
+    if (!map.is_local_prefix_consistent()) {
+        fail(test, seed, "a purely local node out of the local prefix");
+    }
+}
+
+//! lookups promoting hot nodes out of the local prefix, interleaved with insertions and erasures merging them
+void test_promotion_with_erasures()
+{
+    using Alloc = FarMalloc::CollectiveAllocator<ValueType, PageSize>;
+
+    for (unsigned seed = 0; seed != 20; seed++) {
+        FarMemoryContainer::Blocked::BTreeMap<Key, Mapped, 2, std::less<Key>, Alloc> map{Alloc{PurelyLocalCapacity}};
+        std::map<Key, Mapped> reference;
+        std::mt19937_64 prng{seed};
+        for (size_t i = 0; i != 3000; i++) {
+            const Key key = prng() % KeyRange;
+            map.insert({key, mapped_of(key)});
+            reference.emplace(key, mapped_of(key));
+        }
+        map.promote_hot_nodes(8, 1, 4);
+
+        for (size_t i = 0; i != 20000; i++) {
+            const Key key = prng() % KeyRange;
+            switch (prng() % 4) {
+            case 0:
+            case 1:
+                if ((map.find(key) != map.end()) != reference.contains(key)) {
+                    fail("promotion with erasures", seed, "wrong lookup");
+                }
+                break;
+            case 2:
+                map.insert({key, mapped_of(key)});
+                reference.emplace(key, mapped_of(key));
+                break;
+            default:
+                if (map.erase(key) != reference.erase(key)) {
+                    fail("promotion with erasures", seed, "wrong erasure");
+                }
+                break;
+            }
+        }
+        check_contents("promotion with erasures", seed, map, reference);
+    }
+}
+
+//! pinning and unpinning elements, which evict nodes out of the local prefix and refill it, interleaved with insertions and erasures
+void test_pin_with_insertions_and_erasures()
+{
+    using Alloc = FarMalloc::CollectiveAllocator<ValueType, PageSize>;
+
+    for (unsigned seed = 0; seed != 20; seed++) {
+        FarMemoryContainer::Blocked::BTreeMap<Key, Mapped, 2, std::less<Key>, Alloc, false, false, true> map{Alloc{PurelyLocalCapacity}};
+        std::map<Key, Mapped> reference;
+        std::mt19937_64 prng{seed};
+        for (size_t i = 0; i != 2000; i++) {
+            const Key key = prng() % KeyRange;
+            map.insert({key, mapped_of(key)});
+            reference.emplace(key, mapped_of(key));
+        }
+
+        for (size_t i = 0; i != 10000; i++) {
+            const Key key = prng() % KeyRange;
+            switch (prng() % 5) {
+            case 0:
+                if (map.pin(key) && !reference.contains(key)) {
+                    fail("pin with insertions and erasures", seed, "wrong pin");
+                }
+                break;
+            case 1:
+                if (map.unpin(key) && !reference.contains(key)) {
+                    fail("pin with insertions and erasures", seed, "wrong unpin");
+                }
+                break;
+            case 2:
+            case 3:
+                map.insert({key, mapped_of(key)});
+                reference.emplace(key, mapped_of(key));
+                break;
+            default:
+                if (map.erase(key) != reference.erase(key)) {
+                    fail("pin with insertions and erasures", seed, "wrong erasure");
+                }
+                break;
+            }
+            // checked often, as the next refill of the local prefix may take in the node out of it
+            if (i % 64 == 0 && !map.is_local_prefix_consistent()) {
+                fail("pin with insertions and erasures", seed, "a purely local node out of the local prefix");
+            }
+        }
+        check_contents("pin with insertions and erasures", seed, map, reference);
+    }
+}
+
+//! insertions growing the tree while the purely local region holds only a few nodes,
+//! in which the old root may be the last local node relocated out of it to make room for the new root
+void test_new_root_with_full_local_memory()
+{
+    using Alloc = FarMalloc::CollectiveAllocator<ValueType, PageSize>;
+
+    for (size_t capacity = 256; capacity <= 2048; capacity += 64) {
+        FarMemoryContainer::Blocked::BTreeMap<Key, Mapped, 2, std::less<Key>, Alloc> map{Alloc{capacity}};
+        std::map<Key, Mapped> reference;
+        for (Key key = 0; key != 200; key++) {
+            map.insert({key, mapped_of(key)});
+            reference.emplace(key, mapped_of(key));
+        }
+        check_contents("new root with full local memory", static_cast<unsigned>(capacity), map, reference);
+    }
+}
+
+int main()
+{
+    test_promotion_with_erasures();
+    test_pin_with_insertions_and_erasures();
+    test_new_root_with_full_local_memory();
+
+    std::cout << "ok" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,150 @@
+#include <far_memory_container/blocked/b_plus_tree.hpp>
+#include <far_memory_container/blocked/b_tree.hpp>
+#include <far_memory_container/blocked/skiplist.hpp>
+#include <farmalloc/collective_allocator.hpp>
+#include <farmalloc/page_size.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string_view>
+
+
+// single-threaded tests of the containers in `Blocked` against `std::map`,
+// including the concurrent ones, whose readers in `lookup()` are the optimistic ones
+
+using Key = uint64_t;
+using Mapped = std::array<std::byte, 40>;
+using ValueType = std::pair<const Key, Mapped>;
+using Alloc = FarMalloc::CollectiveAllocator<ValueType, PageSize>;
+
+constexpr size_t PurelyLocalCapacity = 30000;
+constexpr Key KeyRange = 20000;
+
+Mapped mapped_of(Key key, size_t version = 0)
+{
+    Mapped res{};
+    for (size_t i = 0; i != res.size(); i++) {
+        res[i] = static_cast<std::byte>(key * 7 + version + i);
+    }
+    return res;
+}
+
+[[noreturn]] void fail(std::string_view test, unsigned seed, std::string_view what)
+{
+    std::cerr << test << " (seed " << seed << "): " << what << std::endl;
+    std::exit(EXIT_FAILURE);
+}
+
+template <class MapType>
+void check_contents(std::string_view test, unsigned seed, MapType& map, const std::map<Key, Mapped>& reference)
+{
+    if (map.size() != reference.size()) {
+        fail(test, seed, "wrong size");
+    }
+    auto iter = map.begin();
+    for (const auto& [key, mapped] : reference) {
+        if (iter == map.end() || iter->first != key || iter->second != mapped) {
+            fail(test, seed, "wrong element");
+        }
+        ++iter;
+    }
+    if (iter != map.end()) {
+        fail(test, seed, "an element beyond the last one");
+    }
+}
+
+//! insertions, erasures, updates, lookups, and scans in random order, with the contents checked at the end
+//! `lookup()` of the concurrent readers is checked as well as `find()`, if `MapType` has it.
+template <class MapType>
+void test_random_operations(std::string_view test)
+{
+    for (unsigned seed = 0; seed != 10; seed++) {
+        MapType map{Alloc{PurelyLocalCapacity}};
+        std::map<Key, Mapped> reference;
+        std::mt19937_64 prng{seed};
+
+        for (size_t i = 0; i != 30000; i++) {
+            const Key key = prng() % KeyRange;
+            switch (prng() % 8) {
+            case 0:
+            case 1:
+            case 2: {
+                const bool inserted = map.insert({key, mapped_of(key)}).second;
+                if (inserted != reference.emplace(key, mapped_of(key)).second) {
+                    fail(test, seed, "wrong insertion");
+                }
+                break;
+            }
+            case 3:
+            case 4:
+                if (map.erase(key) != reference.erase(key)) {
+                    fail(test, seed, "wrong erasure");
+                }
+                break;
+            case 5:
+                if (const auto iter = reference.find(key); map.update(key, mapped_of(key, i)) != (iter != reference.end())) {
+                    fail(test, seed, "wrong update");
+                } else if (iter != reference.end()) {
+                    iter->second = mapped_of(key, i);
+                }
+                break;
+            case 6: {
+                const auto iter = map.find(key);
+                const auto expected = reference.find(key);
+                if ((iter != map.end()) != (expected != reference.end()) || (iter != map.end() && iter->second != expected->second)) {
+                    fail(test, seed, "wrong lookup by find()");
+                }
+                if constexpr (requires { map.lookup(key); }) {
+                    const auto mapped = map.lookup(key);
+                    if (mapped.has_value() != (expected != reference.end()) || (mapped && *mapped != expected->second)) {
+                        fail(test, seed, "wrong lookup by lookup()");
+                    }
+                }
+                break;
+            }
+            default: {
+                // a range read of the benchmark, which reads nothing if `key` does not exist
+                auto expected = reference.find(key);
+                size_t n_expected = 0;
+                const size_t n = map.scan(key, 8, [&](const ValueType& elem) {
+                    if (expected == reference.end() || elem.first != expected->first || elem.second != expected->second) {
+                        fail(test, seed, "wrong element of a scan");
+                    }
+                    ++expected;
+                }, [](const void*, size_t) {});
+                for (auto iter = reference.find(key); iter != reference.end() && n_expected != 8; ++iter) {
+                    n_expected++;
+                }
+                if (n != n_expected) {
+                    fail(test, seed, "wrong length of a scan");
+                }
+                break;
+            }
+            }
+        }
+        check_contents(test, seed, map, reference);
+
+        map.batch_block();
+        check_contents(test, seed, map, reference);
+    }
+}
+
+int main()
+{
+    using namespace FarMemoryContainer::Blocked;
+
+    test_random_operations<BTreeMap<Key, Mapped, 2, std::less<Key>, Alloc>>("B-tree");
+    test_random_operations<BTreeMap<Key, Mapped, 8, std::less<Key>, Alloc, true>>("B-tree with optimistic lock coupling");
+    test_random_operations<SkiplistMap<Key, Mapped, std::less<Key>, Alloc>>("skip list");
+    test_random_operations<SkiplistMap<Key, Mapped, std::less<Key>, Alloc, std::minstd_rand0, true>>("skip list with epoch-based reclamation");
+    test_random_operations<BPlusTreeMap<Key, Mapped, 8, 12, std::less<Key>, Alloc>>("B+-tree");
+
+    std::cout << "ok" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,119 @@
+#include <far_memory_container/blocked/b_tree.hpp>
+#include <far_memory_container/key_search.hpp>
+#include <farmalloc/collective_allocator.hpp>
+#include <farmalloc/page_size.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <string_view>
+
+
+// tests of the search of the keys of a node (`upper_bound_in_keys`), which compares them by SIMD instructions
+// if this test is built with `KEY_SEARCH_ISA` of avx2 or avx512f, against the scalar search of the same keys
+
+//! `std::less` the search does not recognize, which forces the scalar search
+struct ScalarLess {
+    template <class Key>
+    bool operator()(const Key& lhs, const Key& rhs) const { return lhs < rhs; }
+};
+
+[[noreturn]] void fail(std::string_view test, unsigned seed, std::string_view what)
+{
+    std::cerr << test << " (seed " << seed << "): " << what << std::endl;
+    std::exit(EXIT_FAILURE);
+}
+
+//! the keys of every number of the elements in a node, and the stale keys beyond them
+//! The keys are drawn from a narrow range to include duplicates, or around the extremes to include those beyond the sign bits.
+template <class Key, size_t MaxNElems>
+void test_upper_bound_in_keys(std::string_view test)
+{
+    using Keys = FarMemoryContainer::KeyArray<Key, MaxNElems>;
+
+    for (unsigned seed = 0; seed != 200; seed++) {
+        std::mt19937_64 prng{seed};
+        const auto draw = [&]() -> Key {
+            switch (seed % 3) {
+            case 0:
+                return static_cast<Key>(prng() % (2 * MaxNElems));
+            case 1:
+                return static_cast<Key>(std::numeric_limits<Key>::min() + prng() % 64);
+            default:
+                return static_cast<Key>(std::numeric_limits<Key>::max() - prng() % 64);
+            }
+        };
+
+        for (size_t n = 0; n <= MaxNElems; n++) {
+            Keys keys;
+            for (auto& key : keys.keys) {
+                key = static_cast<Key>(prng());
+            }
+            std::sort(keys.keys.begin(), keys.keys.begin() + n);
+
+            for (size_t i = 0; i != 64; i++) {
+                const Key key = (i % 2 == 0 && n != 0) ? keys.keys[prng() % n] : draw();
+                const auto expected = static_cast<size_t>(std::upper_bound(keys.keys.begin(), keys.keys.begin() + n, key) - keys.keys.begin());
+                if (FarMemoryContainer::upper_bound_in_keys(keys.keys, n, key, ScalarLess{}) != expected) {
+                    fail(test, seed, "wrong result of the scalar search");
+                }
+                if (FarMemoryContainer::upper_bound_in_keys(keys.keys, n, key, std::less<Key>{}) != expected) {
+                    fail(test, seed, "the search by std::less differs from the scalar search");
+                }
+            }
+        }
+    }
+}
+
+//! a wide B-tree searching the copies of the keys, which must be refreshed by every modification of a node
+void test_separate_keys_b_tree()
+{
+    using Key = uint64_t;
+    using Mapped = std::array<std::byte, 40>;
+    using ValueType = std::pair<const Key, Mapped>;
+    using Alloc = FarMalloc::CollectiveAllocator<ValueType, PageSize>;
+
+    for (unsigned seed = 0; seed != 10; seed++) {
+        FarMemoryContainer::Blocked::BTreeMap<Key, Mapped, 16, std::less<Key>, Alloc, false, true> map{Alloc{30000}};
+        std::map<Key, Mapped> reference;
+        std::mt19937_64 prng{seed};
+        for (size_t i = 0; i != 20000; i++) {
+            const Key key = prng() % 10000;
+            if (prng() % 3 == 0) {
+                if (map.erase(key) != reference.erase(key)) {
+                    fail("B-tree with separate keys", seed, "wrong erasure");
+                }
+            } else {
+                const Mapped mapped{static_cast<std::byte>(key)};
+                map.insert({key, mapped});
+                reference.emplace(key, mapped);
+            }
+            if (const auto iter = map.find(key); (iter != map.end()) != reference.contains(key) || (iter != map.end() && iter->first != key)) {
+                fail("B-tree with separate keys", seed, "wrong lookup");
+            }
+        }
+        if (map.size() != reference.size() || !std::equal(map.begin(), map.end(), reference.begin(), reference.end())) {
+            fail("B-tree with separate keys", seed, "wrong contents");
+        }
+    }
+}
+
+int main()
+{
+    test_upper_bound_in_keys<uint64_t, 16>("uint64_t");
+    test_upper_bound_in_keys<int64_t, 16>("int64_t");
+    test_upper_bound_in_keys<uint32_t, 24>("uint32_t");
+    test_upper_bound_in_keys<int32_t, 24>("int32_t");
+    test_upper_bound_in_keys<uint64_t, 3>("uint64_t of 3 elements");
+    test_separate_keys_b_tree();
+
+    std::cout << "ok (" << FarMemoryContainer::KeySearchLanes<uint64_t> << " keys of 64 bits compared at once)" << std::endl;
+    return EXIT_SUCCESS;
+}
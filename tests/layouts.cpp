@@ -0,0 +1,183 @@
+#include <far_memory_container/blocked/b_tree.hpp>
+#include <far_memory_container/blocked/skiplist.hpp>
+#include <farmalloc/collective_allocator.hpp>
+#include <farmalloc/page_size.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <ranges>
+#include <string_view>
+#include <vector>
+
+
+// tests of the page-aware layouts of the containers in `Blocked` against `std::map`, i.e., the bulk loading,
+// the batch and incremental rearrangements in the depth-first and the vEB orders, and the finger search on them
+
+using Key = uint64_t;
+using Mapped = std::array<std::byte, 40>;
+using ValueType = std::pair<const Key, Mapped>;
+using Alloc = FarMalloc::CollectiveAllocator<ValueType, PageSize>;
+
+constexpr size_t PurelyLocalCapacity = 30000;
+constexpr Key KeyRange = 40000;
+
+Mapped mapped_of(Key key)
+{
+    Mapped res{};
+    for (size_t i = 0; i != res.size(); i++) {
+        res[i] = static_cast<std::byte>(key * 7 + i);
+    }
+    return res;
+}
+
+[[noreturn]] void fail(std::string_view test, unsigned seed, std::string_view what)
+{
+    std::cerr << test << " (seed " << seed << "): " << what << std::endl;
+    std::exit(EXIT_FAILURE);
+}
+
+template <class MapType>
+void check_contents(std::string_view test, unsigned seed, MapType& map, const std::map<Key, Mapped>& reference)
+{
+    if (map.size() != reference.size()) {
+        fail(test, seed, "wrong size");
+    }
+    auto iter = map.begin();
+    for (const auto& [key, mapped] : reference) {
+        if (iter == map.end() || iter->first != key || iter->second != mapped) {
+            fail(test, seed, "wrong element");
+        }
+        ++iter;
+    }
+}
+
+//! lookups from the result of the previous one, as those of the keys near each other, and from `end()`
+template <class MapType>
+void check_finger_search(std::string_view test, unsigned seed, MapType& map, const std::map<Key, Mapped>& reference, std::mt19937_64& prng)
+{
+    auto hint = map.cbegin();
+    for (size_t i = 0; i != 2000; i++) {
+        const Key key = (i % 8 == 0) ? prng() % KeyRange : (hint == map.cend() ? 0 : hint->first) + prng() % 64;
+        const auto from = (i % 16 == 0) ? map.cend() : hint;
+
+        const auto expected = reference.lower_bound(key);
+        const auto iter = map.lower_bound(from, key);
+        if ((iter == map.end()) != (expected == reference.end()) || (iter != map.end() && iter->first != expected->first)) {
+            fail(test, seed, "wrong lower bound by finger search");
+        }
+        const auto found = map.find(from, key);
+        if ((found != map.end()) != reference.contains(key) || (found != map.end() && found->first != key)) {
+            fail(test, seed, "wrong lookup by finger search");
+        }
+        hint = iter;
+    }
+}
+
+//! insertions and erasures after a layout, which move the nodes out of it
+template <class MapType>
+void churn(std::string_view test, unsigned seed, MapType& map, std::map<Key, Mapped>& reference, std::mt19937_64& prng)
+{
+    for (size_t i = 0; i != 5000; i++) {
+        const Key key = prng() % KeyRange;
+        if (prng() % 2 == 0) {
+            map.insert({key, mapped_of(key)});
+            reference.emplace(key, mapped_of(key));
+        } else if (map.erase(key) != reference.erase(key)) {
+            fail(test, seed, "wrong erasure");
+        }
+    }
+    check_contents(test, seed, map, reference);
+}
+
+//! the sorted elements of `KeyRange / 2` random keys
+std::map<Key, Mapped> random_elements(std::mt19937_64& prng)
+{
+    std::map<Key, Mapped> res;
+    while (res.size() != KeyRange / 2) {
+        const Key key = prng() % KeyRange;
+        res.emplace(key, mapped_of(key));
+    }
+    return res;
+}
+
+//! @param layout constructs `map` with the elements of `reference`
+template <class MapType, class Layout>
+void test_layout(std::string_view test, Layout&& layout)
+{
+    for (unsigned seed = 0; seed != 5; seed++) {
+        MapType map{Alloc{PurelyLocalCapacity}};
+        std::mt19937_64 prng{seed};
+        auto reference = random_elements(prng);
+
+        layout(map, reference);
+        check_contents(test, seed, map, reference);
+        check_finger_search(test, seed, map, reference, prng);
+        churn(test, seed, map, reference, prng);
+        check_finger_search(test, seed, map, reference, prng);
+    }
+}
+
+//! the elements of `reference` in ascending order, as the bulk loading takes
+auto sorted_elements(const std::map<Key, Mapped>& reference)
+{
+    return reference | std::views::transform([](const auto& elem) { return ValueType{elem.first, elem.second}; });
+}
+
+template <class MapType>
+void insert_all(MapType& map, const std::map<Key, Mapped>& reference, std::mt19937_64& prng)
+{
+    std::vector<Key> keys;
+    for (const auto& elem : reference) {
+        keys.push_back(elem.first);
+    }
+    std::shuffle(keys.begin(), keys.end(), prng);
+    for (const auto key : keys) {
+        map.insert({key, mapped_of(key)});
+    }
+}
+
+int main()
+{
+    using namespace FarMemoryContainer::Blocked;
+    using BTree = BTreeMap<Key, Mapped, 8, std::less<Key>, Alloc>;
+    using Skiplist = SkiplistMap<Key, Mapped, std::less<Key>, Alloc>;
+
+    std::mt19937_64 prng;
+    test_layout<BTree>("B-tree, bulk loading in the depth-first order", [](auto& map, const auto& reference) { map.bulk_load_block(sorted_elements(reference)); });
+    test_layout<BTree>("B-tree, bulk loading in the vEB order", [](auto& map, const auto& reference) { map.bulk_load_vEB(sorted_elements(reference)); });
+    test_layout<BTree>("B-tree, batch rearrangement in the depth-first order", [&](auto& map, const auto& reference) {
+        insert_all(map, reference, prng);
+        map.batch_block();
+    });
+    test_layout<BTree>("B-tree, batch rearrangement in the vEB order", [&](auto& map, const auto& reference) {
+        insert_all(map, reference, prng);
+        map.batch_vEB();
+    });
+    test_layout<BTree>("B-tree, batch rearrangement in the multi-level vEB order", [&](auto& map, const auto& reference) {
+        insert_all(map, reference, prng);
+        map.template batch_multilevel_vEB<PageSize>();
+    });
+    test_layout<BTree>("B-tree, incremental rearrangement in the depth-first order", [&](auto& map, const auto& reference) {
+        map.template incremental_block<PageSize>(1000);
+        insert_all(map, reference, prng);
+    });
+    test_layout<BTree>("B-tree, incremental rearrangement in the vEB order", [&](auto& map, const auto& reference) {
+        map.template incremental_vEB<PageSize>(1000);
+        insert_all(map, reference, prng);
+    });
+    test_layout<Skiplist>("skip list, bulk loading", [](auto& map, const auto& reference) { map.bulk_load(sorted_elements(reference)); });
+    test_layout<Skiplist>("skip list, batch rearrangement in the vEB order", [&](auto& map, const auto& reference) {
+        insert_all(map, reference, prng);
+        map.batch_vEB();
+    });
+
+    std::cout << "ok" << std::endl;
+    return EXIT_SUCCESS;
+}
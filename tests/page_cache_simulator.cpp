@@ -0,0 +1,70 @@
+#include <far_memory_container/page_cache_simulator.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+
+// tests of `PageCacheSimulator` by the reference strings whose misses are known for each replacement policy
+
+using FarMemoryContainer::PageCacheSimulator;
+using FarMemoryContainer::PageReplacement;
+
+[[noreturn]] void fail(std::string_view test, size_t capacity, std::string_view what)
+{
+    std::cerr << test << " (" << capacity << " pages): " << what << std::endl;
+    std::exit(EXIT_FAILURE);
+}
+
+void check_misses(std::string_view test, const std::vector<uintptr_t>& pages, size_t capacity, PageReplacement policy, size_t n_misses)
+{
+    PageCacheSimulator cache{capacity, policy};
+    for (const auto page_id : pages) {
+        cache.access(page_id);
+    }
+    if (cache.n_misses() != n_misses) {
+        fail(test, capacity, "wrong number of the misses");
+    }
+    if (cache.n_hits() + cache.n_misses() != pages.size()) {
+        fail(test, capacity, "wrong number of the hits");
+    }
+    // a miss evicts a page once the cache is full, i.e., after as many misses as the pages in it, unless it caches nothing
+    if (cache.n_evictions() != (capacity != 0 && n_misses > capacity ? n_misses - capacity : 0)) {
+        fail(test, capacity, "wrong number of the evictions");
+    }
+}
+
+int main()
+{
+    // the reference string of Belady's anomaly, with which FIFO misses more in the larger cache
+    const std::vector<uintptr_t> belady{1, 2, 3, 4, 1, 2, 5, 1, 2, 3, 4, 5};
+    check_misses("FIFO, Belady's anomaly", belady, 3, PageReplacement::FIFO, 9);
+    check_misses("FIFO, Belady's anomaly", belady, 4, PageReplacement::FIFO, 10);
+    check_misses("LRU, Belady's anomaly", belady, 3, PageReplacement::LRU, 10);
+    check_misses("LRU, Belady's anomaly", belady, 4, PageReplacement::LRU, 8);
+    // The pages inserted by a miss are not referenced, so the hits on 1 and 2 make 5 the victim of the miss on 3.
+    check_misses("CLOCK, Belady's anomaly", belady, 3, PageReplacement::CLOCK, 10);
+
+    // a hit on the oldest page keeps it in the cache of LRU and CLOCK, but not in that of FIFO
+    const std::vector<uintptr_t> reused{1, 2, 3, 1, 4, 5, 1};
+    check_misses("FIFO, a page reused", reused, 3, PageReplacement::FIFO, 6);
+    check_misses("LRU, a page reused", reused, 3, PageReplacement::LRU, 5);
+    check_misses("CLOCK, a page reused", reused, 3, PageReplacement::CLOCK, 5);
+
+    // a cyclic scan of one more page than the cache misses every time in any of them
+    std::vector<uintptr_t> cyclic;
+    for (size_t i = 0; i != 100; i++) {
+        cyclic.push_back(i % 5);
+    }
+    for (const auto policy : {PageReplacement::FIFO, PageReplacement::LRU, PageReplacement::CLOCK}) {
+        check_misses("a cyclic scan", cyclic, 4, policy, 100);
+        check_misses("a cyclic scan", cyclic, 5, policy, 5);
+        check_misses("no cache", cyclic, 0, policy, 100);
+    }
+
+    std::cout << "ok" << std::endl;
+    return EXIT_SUCCESS;
+}